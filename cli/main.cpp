@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "analysis.h"
+#include "bytearray.h"
+#include "decrypt.h"
+#ifndef _WIN32
+#include "result_cache.h"
+#endif
+
+using namespace CryptoFriends;
+
+static constexpr char USAGE[] =
+    "Usage: cryptofriends <analysis> [options] [file...]\n"
+    "\n"
+    "Analyses:\n"
+    "  single-byte     find the best single-byte XOR key\n"
+    "  repeating-key   break repeating-key XOR\n"
+    "  ecb             count repeated 16-byte blocks to detect AES-ECB\n"
+    "  aes             decrypt AES-ECB (requires --key)\n"
+    "\n"
+    "Options:\n"
+    "  --hex           inputs are hex encoded\n"
+    "  --base64        inputs are base64 encoded (default)\n"
+    "  --lines         treat every non-empty line as a separate input\n"
+    "  --key KEY       AES key for the aes analysis\n"
+    "  --min-key N     smallest repeating key size to try (default 2)\n"
+    "  --max-key N     largest repeating key size to try (default 40)\n"
+    "  --tries N       number of ranked key sizes to try (default 35)\n"
+    "  -j N            worker threads (default: hardware concurrency)\n"
+#ifndef _WIN32
+    "  --cache FILE    reuse single-byte and repeating-key results stored in FILE,\n"
+    "                  and store new ones there\n"
+#endif
+    "\n"
+    "Reads stdin when no files are given or a file is \"-\" (at most once).\n"
+    "Writes one JSON object per input to stdout.\n";
+
+enum class Analysis { SingleByte, RepeatingKey, Ecb, Aes };
+enum class Encoding { Hex, Base64 };
+
+struct Options{
+    Analysis analysis;
+    Encoding encoding = Encoding::Base64;
+    bool lines = false;
+    std::string key;
+    size_t min_key_size = 2;
+    size_t max_key_size = 40;
+    size_t key_sizes_to_try = 35;
+    size_t n_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string cache_path;
+    std::vector<std::string> files;
+};
+
+static bool parseSize(const char* str, size_t& out){
+    char* end;
+    unsigned long long value = std::strtoull(str, &end, 10);
+    if(end == str || *end != '\0') return false;
+    out = static_cast<size_t>(value);
+    return true;
+}
+
+static bool parseArgs(int argc, char** argv, Options& options){
+    if(argc < 2) return false;
+
+    std::string_view analysis = argv[1];
+    if(analysis == "single-byte") options.analysis = Analysis::SingleByte;
+    else if(analysis == "repeating-key") options.analysis = Analysis::RepeatingKey;
+    else if(analysis == "ecb") options.analysis = Analysis::Ecb;
+    else if(analysis == "aes") options.analysis = Analysis::Aes;
+    else return false;
+
+    bool has_key = false;
+    for(int i = 2; i < argc; i++){
+        std::string_view arg = argv[i];
+        const bool has_value = i+1 < argc;
+        if(arg == "--hex") options.encoding = Encoding::Hex;
+        else if(arg == "--base64") options.encoding = Encoding::Base64;
+        else if(arg == "--lines") options.lines = true;
+        else if(arg == "--key" && has_value){ options.key = argv[++i]; has_key = true; }
+        else if(arg == "--min-key" && has_value){ if(!parseSize(argv[++i], options.min_key_size)) return false; }
+        else if(arg == "--max-key" && has_value){ if(!parseSize(argv[++i], options.max_key_size)) return false; }
+        else if(arg == "--tries" && has_value){ if(!parseSize(argv[++i], options.key_sizes_to_try)) return false; }
+        else if(arg == "-j" && has_value){ if(!parseSize(argv[++i], options.n_threads)) return false; }
+        else if(arg == "--cache" && has_value) options.cache_path = argv[++i];
+        else if(arg.size() > 1 && arg[0] == '-') return false;
+        else options.files.push_back(argv[i]);
+    }
+
+    //Workers read their own inputs, so stdin may only be named once
+    if(options.files.empty()) options.files.push_back("-");
+    if(std::count(options.files.begin(), options.files.end(), "-") > 1) return false;
+    if(options.n_threads == 0) options.n_threads = 1;
+    if(options.min_key_size == 0 || options.min_key_size > options.max_key_size || options.key_sizes_to_try == 0) return false;
+    if(options.analysis == Analysis::Aes){
+        if(!has_key) return false;
+        const size_t key_bits = options.key.size() * BITS_PER_BYTE;
+        if(key_bits != 128 && key_bits != 192 && key_bits != 256) return false;
+    }
+
+    return true;
+}
+
+static bool readInput(const std::string& file_name, std::string& out){
+    if(file_name == "-"){
+        std::stringstream buffer;
+        buffer << std::cin.rdbuf();
+        out = buffer.str();
+        return true;
+    }
+
+    std::ifstream in(file_name, std::ios::binary);
+    if(!in.is_open()) return false;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+static void appendJsonString(std::string& out, std::string_view str){
+    //Bytes outside ASCII are escaped as code points so binary plaintext still yields valid JSON
+    static constexpr char HEX_CHARS[] = "0123456789abcdef";
+    out += '"';
+    for(uint8_t ch : str){
+        if(ch == '"') out += "\\\"";
+        else if(ch == '\\') out += "\\\\";
+        else if(ch == '\n') out += "\\n";
+        else if(ch == '\r') out += "\\r";
+        else if(ch == '\t') out += "\\t";
+        else if(ch < 0x20 || ch >= 0x7f){
+            out += "\\u00";
+            out += HEX_CHARS[ch >> 4];
+            out += HEX_CHARS[ch & 0xf];
+        }else out += static_cast<char>(ch);
+    }
+    out += '"';
+}
+
+static std::string toHex(std::string_view bytes){
+    return ByteArray::fromAscii(bytes).toHexString();
+}
+
+static bool decodeInput(std::string_view encoded, Encoding encoding, std::string& bytes, std::string& error){
+    std::string cleaned;
+    cleaned.reserve(encoded.size());
+    for(char ch : encoded){
+        if(ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t') continue;
+        cleaned += ch;
+    }
+
+    if(cleaned.empty()){
+        error = "empty input";
+        return false;
+    }
+
+    if(encoding == Encoding::Hex){
+        for(char& ch : cleaned){
+            if(ch >= 'A' && ch <= 'F') ch += 'a' - 'A';
+            if(!((ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f'))){
+                error = "invalid hex character";
+                return false;
+            }
+        }
+        if(cleaned.size() % 2){
+            error = "odd number of hex characters";
+            return false;
+        }
+        bytes = ByteArray::fromHexString(cleaned).toAscii();
+    }else{
+        const size_t data_end = cleaned.find_last_not_of('=') + 1;
+        if(cleaned.size() % 4 || cleaned.size() - data_end > 2){
+            error = "invalid base64 length";
+            return false;
+        }
+        for(size_t i = 0; i < data_end; i++){
+            const char ch = cleaned[i];
+            if(!((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || ch == '+' || ch == '/')){
+                error = "invalid base64 character";
+                return false;
+            }
+        }
+        bytes = ByteArray::fromBase64String(cleaned).toAscii();
+    }
+
+    return true;
+}
+
+#ifndef _WIN32
+static std::string cacheParameters(const Options& options){
+    //Everything besides the ciphertext which can change a result; bump the version if an analysis changes
+    static constexpr char VERSION[] = "v3";
+    switch(options.analysis){
+        case Analysis::SingleByte:
+            return std::string(VERSION) + " single-byte";
+        case Analysis::RepeatingKey:
+            return std::string(VERSION) + " repeating-key " + std::to_string(options.min_key_size) + " "
+                 + std::to_string(options.max_key_size) + " " + std::to_string(options.key_sizes_to_try);
+        default:
+            return {};
+    }
+}
+
+static bool lookupCached(ResultCache* cache, const Options& options, std::string_view bytes,
+                         std::string& key, double& score, std::string& plain_text){
+    //A hit recovers the plaintext from the stored key, skipping the analysis
+    if(!cache) return false;
+    ResultCache::Entry entry;
+    if(!cache->lookup(resultCacheKey(bytes, cacheParameters(options)), bytes.size(), entry)) return false;
+    if(entry.key.empty() || entry.plaintext_offset > bytes.size()) return false;
+
+    ByteArray decrypted = ByteArray::fromAscii(bytes.substr(entry.plaintext_offset));
+    decrypted.applyRepeatingKeyXor(entry.key);
+    key = std::move(entry.key);
+    score = entry.score;
+    plain_text = decrypted.toAscii();
+    return true;
+}
+
+static void storeCached(ResultCache* cache, const Options& options, std::string_view bytes,
+                        const std::string& key, double score){
+    if(!cache || key.empty()) return;
+    const ResultCache::Entry entry = {.key = key, .plaintext_offset = 0, .score = score};
+    cache->insert(resultCacheKey(bytes, cacheParameters(options)), bytes.size(), entry);
+}
+#else
+//The result cache memory-maps its file with POSIX calls, so Windows builds analyse every input from scratch
+class ResultCache{};
+
+static bool lookupCached(ResultCache*, const Options&, std::string_view, std::string&, double&, std::string&){
+    return false;
+}
+
+static void storeCached(ResultCache*, const Options&, std::string_view, const std::string&, double){}
+#endif
+
+static std::string analyse(const Options& options, std::string_view bytes, ResultCache* cache, bool& failed){
+    std::ostringstream out;
+    out << std::setprecision(6);
+    std::string json;
+
+    switch(options.analysis){
+        case Analysis::SingleByte:{
+            std::string key;
+            double score;
+            std::string plain_text;
+            const bool cached = lookupCached(cache, options, bytes, key, score, plain_text);
+            if(!cached){
+                SingleByteXorResult result = bestSingleByteXor(ByteArray::fromAscii(bytes));
+                key = std::string(1, static_cast<char>(result.key));
+                score = result.score;
+                plain_text = std::move(result.plain_text);
+                storeCached(cache, options, bytes, key, score);
+            }
+            out << ",\"analysis\":\"single-byte\",\"key\":" << static_cast<unsigned>(static_cast<uint8_t>(key[0]))
+                << ",\"score\":" << score << (cached ? ",\"cached\":true" : "") << ",\"plaintext\":";
+            json = out.str();
+            appendJsonString(json, plain_text);
+            break;
+        }
+        case Analysis::RepeatingKey:{
+            std::string key;
+            double score;
+            std::string plain_text;
+            const bool cached = lookupCached(cache, options, bytes, key, score, plain_text);
+            if(!cached){
+                RepeatingXorResult result = breakRepeatingKeyXor(
+                    ByteArray::fromAscii(bytes), options.min_key_size, options.max_key_size, options.key_sizes_to_try);
+                if(result.key.empty()){
+                    //Every key size needs two whole blocks to compare, so short inputs have no candidates
+                    failed = true;
+                    return ",\"error\":\"input is too short for the smallest key size\"";
+                }
+                key = std::move(result.key);
+                score = result.score;
+                plain_text = std::move(result.plain_text);
+                storeCached(cache, options, bytes, key, score);
+            }
+            out << ",\"analysis\":\"repeating-key\",\"key_size\":" << key.size()
+                << ",\"score\":" << score << (cached ? ",\"cached\":true" : "")
+                << ",\"key_hex\":\"" << toHex(key) << "\",\"key\":";
+            json = out.str();
+            appendJsonString(json, key);
+            json += ",\"plaintext\":";
+            appendJsonString(json, plain_text);
+            break;
+        }
+        case Analysis::Ecb:{
+            const size_t repeats = repeatedBlocks(bytes, AES_BLOCK_SIZE);
+            out << ",\"analysis\":\"ecb\",\"blocks\":" << bytes.size() / AES_BLOCK_SIZE
+                << ",\"repeated_blocks\":" << repeats << ",\"ecb\":" << (repeats > 0 ? "true" : "false");
+            json = out.str();
+            break;
+        }
+        case Analysis::Aes:{
+            if(bytes.size() % AES_BLOCK_SIZE){
+                failed = true;
+                return ",\"error\":\"ciphertext is not a whole number of blocks\"";
+            }
+            json = ",\"analysis\":\"aes\",\"plaintext\":";
+            appendJsonString(json, decrypt(std::string(bytes), options.key));
+            break;
+        }
+    }
+
+    return json;
+}
+
+static std::string processInput(const Options& options, std::string_view encoded, ResultCache* cache, bool& failed){
+    std::string bytes;
+    std::string error;
+    if(!decodeInput(encoded, options.encoding, bytes, error)){
+        failed = true;
+        std::string json = ",\"error\":";
+        appendJsonString(json, error);
+        return json;
+    }
+
+    return analyse(options, bytes, cache, failed);
+}
+
+static std::string processFile(const Options& options, const std::string& file_name, ResultCache* cache, bool& failed){
+    std::string file_json;
+    appendJsonString(file_json, file_name);
+
+    std::string contents;
+    if(!readInput(file_name, contents)){
+        failed = true;
+        return "{\"file\":" + file_json + ",\"error\":\"could not open file\"}\n";
+    }
+
+    std::string records;
+    if(!options.lines){
+        records += "{\"file\":" + file_json + processInput(options, contents, cache, failed) + "}\n";
+        return records;
+    }
+
+    std::istringstream in(contents);
+    std::string line;
+    for(size_t line_num = 1; std::getline(in, line); line_num++){
+        if(line.empty() || line == "\r") continue;
+        records += "{\"file\":" + file_json + ",\"line\":" + std::to_string(line_num)
+                 + processInput(options, line, cache, failed) + "}\n";
+    }
+
+    return records;
+}
+
+int main(int argc, char** argv){
+    std::ios::sync_with_stdio(false);
+
+    Options options;
+    if(!parseArgs(argc, argv, options)){
+        std::cerr << USAGE;
+        return 2;
+    }
+
+    ResultCache* cache = nullptr;
+#ifndef _WIN32
+    ResultCache result_cache;
+    if(!options.cache_path.empty()){
+        if(result_cache.open(options.cache_path)) cache = &result_cache;
+        else std::cerr << "cryptofriends: could not open cache " << options.cache_path << ", continuing without it\n";
+    }
+#else
+    if(!options.cache_path.empty())
+        std::cerr << "cryptofriends: --cache is not available on Windows, continuing without it\n";
+#endif
+
+    //Workers claim files from a shared counter and stream each file's records as soon as it is done
+    std::atomic<size_t> next_file = 0;
+    std::atomic<bool> any_failed = false;
+    std::mutex output_mutex;
+
+    auto worker = [&](){
+        for(size_t i = next_file++; i < options.files.size(); i = next_file++){
+            bool failed = false;
+            const std::string records = processFile(options, options.files[i], cache, failed);
+            if(failed) any_failed = true;
+
+            std::lock_guard<std::mutex> lock(output_mutex);
+            std::cout << records << std::flush;
+        }
+    };
+
+    const size_t n_threads = std::min(options.n_threads, options.files.size());
+    std::vector<std::thread> threads;
+    for(size_t i = 1; i < n_threads; i++) threads.emplace_back(worker);
+    worker();
+    for(std::thread& thread : threads) thread.join();
+
+    return any_failed ? 1 : 0;
+}
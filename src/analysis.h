@@ -0,0 +1,280 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include "bytearray.h"
+#include "fft.h"
+#include "text_frequency_analysis.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace CryptoFriends {
+
+struct SingleByteXorResult{
+    uint8_t key;
+    double score;
+    std::string plain_text;
+};
+
+SingleByteXorResult bestSingleByteXor(const ByteArray& cipher){
+    assert(cipher.numBytes() > 0);
+
+    SingleByteXorResult result = {.key = 0, .score = std::numeric_limits<double>::max(), .plain_text = {}};
+    for(size_t i = 0; i < PERMUTATIONS_PER_BYTE; i++){
+        double score = cipher.scoreGuess(0, 1, static_cast<uint8_t>(i));
+        if(score < result.score){
+            result.score = score;
+            result.key = static_cast<uint8_t>(i);
+        }
+    }
+
+    ByteArray decrypted = cipher;
+    decrypted.applyRepeatingKeyXor(std::string(1, static_cast<char>(result.key)));
+    result.plain_text = decrypted.toAscii();
+
+    return result;
+}
+
+struct KeySizeScore{
+    size_t key_size;
+    double normalised_edit_distance;
+};
+
+std::vector<KeySizeScore> rankKeySizesByHamming(const ByteArray& cipher, size_t min_key_size, size_t max_key_size){
+    //Compares the first two key-sized blocks; the right key size should look least random
+    assert(min_key_size > 0);
+    std::vector<KeySizeScore> results;
+    max_key_size = std::min(max_key_size, cipher.numBytes() / 2);
+
+    const size_t first = cipher.numBytes() - 1;
+    for(size_t key_size = min_key_size; key_size <= max_key_size; key_size++){
+        size_t differing_bits = 0;
+
+        for(size_t byte = 0; byte < key_size; byte++){
+            const size_t a = cipher.getByte(first - byte);
+            const size_t b = cipher.getByte(first - key_size - byte);
+            const size_t diff = a ^ b;
+            for(uint8_t j = 0; j < BITS_PER_BYTE; j++)
+                differing_bits += isBitSet(diff, j);
+        }
+
+        results.push_back(KeySizeScore{
+            .key_size = key_size,
+            .normalised_edit_distance = static_cast<double>(differing_bits) / key_size
+        });
+    }
+
+    std::sort(
+        results.begin(),
+        results.end(),
+        [](const KeySizeScore& a, const KeySizeScore& b){return a.normalised_edit_distance < b.normalised_edit_distance;}
+    );
+
+    return results;
+}
+
+std::vector<KeySizeScore> autocorrelationByKeySize(const ByteArray& cipher, size_t min_key_size, size_t max_key_size){
+    //Scores every shift at once over the whole ciphertext: the mean differing bits per byte between
+    //   the ciphertext and itself shifted by the key size. Shifts that are multiples of the key size
+    //   cancel the key and compare plaintext with plaintext, which looks least random.
+    //Each bit plane becomes a +/-1 signal whose correlation (matches - mismatches) comes from FFTs.
+    //   Two planes share a complex signal, as the real part of its correlation is the sum of both.
+    //The ciphertext is cut into blocks which are correlated against a window reaching max_key_size further,
+    //   so the FFTs stay cache sized however long it is. Block spectra add up, leaving one inverse FFT.
+    assert(min_key_size > 0);
+    const std::string bytes = cipher.toAscii();
+    const size_t n = bytes.size();
+    max_key_size = std::min(max_key_size, n / 2);
+    if(min_key_size > max_key_size) return {};
+
+    static constexpr size_t MIN_FFT_SIZE = 4096;
+    size_t fft_size = MIN_FFT_SIZE;
+    while(fft_size < 4*(max_key_size+1)) fft_size <<= 1;
+    size_t whole_size = 1;
+    while(whole_size < n + max_key_size + 1) whole_size <<= 1;
+    fft_size = std::min(fft_size, whole_size);
+
+    const Fft plan(fft_size);
+    const size_t block_size = fft_size - max_key_size;
+    ComplexSignal spectrum(fft_size, 0);
+    ComplexSignal block(fft_size);
+    ComplexSignal window(fft_size);
+
+    for(size_t start = 0; start < n; start += block_size){
+        const size_t block_end = std::min(start + block_size, n);
+        const size_t window_end = std::min(block_end + max_key_size, n);
+
+        for(uint8_t plane = 0; plane < BITS_PER_BYTE; plane += 2){
+            std::fill(window.begin(), window.end(), 0);
+            for(size_t i = start; i < window_end; i++){
+                const uint8_t byte = static_cast<uint8_t>(bytes[i]);
+                window[i - start] = {isBitSet(byte, plane) ? 1.0 : -1.0, isBitSet(byte, plane+1) ? 1.0 : -1.0};
+            }
+            std::fill(block.begin(), block.end(), 0);
+            std::copy(window.begin(), window.begin() + (block_end - start), block.begin());
+
+            plan.forward(block);
+            plan.forward(window);
+            for(size_t i = 0; i < fft_size; i++){
+                const std::complex<double> a = block[i];
+                const std::complex<double> b = window[i];
+                spectrum[i] += std::complex<double>(a.real()*b.real() + a.imag()*b.imag(), a.real()*b.imag() - a.imag()*b.real());
+            }
+        }
+    }
+
+    plan.inverse(spectrum);
+
+    std::vector<KeySizeScore> results;
+    results.reserve(max_key_size - min_key_size + 1);
+    for(size_t key_size = min_key_size; key_size <= max_key_size; key_size++){
+        const size_t overlap = n - key_size;
+        const double correlation = spectrum[key_size].real() / fft_size;
+        const double differing_bits = (BITS_PER_BYTE*overlap - correlation) / 2;
+        results.push_back(KeySizeScore{
+            .key_size = key_size,
+            .normalised_edit_distance = differing_bits / overlap
+        });
+    }
+
+    return results;
+}
+
+const KeySizeScore& lowestScore(const std::vector<KeySizeScore>& scores) noexcept {
+    assert(!scores.empty());
+    const KeySizeScore* best = &scores.front();
+    for(const KeySizeScore& score : scores)
+        if(score.normalised_edit_distance < best->normalised_edit_distance) best = &score;
+
+    return *best;
+}
+
+size_t likelyKeySizeFromScores(const std::vector<KeySizeScore>& scores){
+    //Every multiple of the key size scores about as well as the key size itself, so the best shift may be a multiple.
+    //   A divisor of it is the key size if its own multiples score as low as the best shift's multiples;
+    //   a divisor which is too small has higher scoring shifts among its multiples, raising their mean.
+    if(scores.empty()) return 0;
+    const KeySizeScore& best = lowestScore(scores);
+
+    auto meanScores = [&scores](size_t key_size, bool multiples){
+        double sum = 0;
+        size_t n = 0;
+        for(const KeySizeScore& score : scores){
+            if((score.key_size % key_size == 0) != multiples) continue;
+            sum += score.normalised_edit_distance;
+            n++;
+        }
+        return n ? sum / n : 0;
+    };
+
+    const double best_mean = meanScores(best.key_size, true);
+    const double others_mean = meanScores(best.key_size, false);
+    const double threshold = best_mean + (others_mean - best_mean) / 4;
+    for(size_t key_size = scores.front().key_size; key_size < best.key_size; key_size++)
+        if(best.key_size % key_size == 0 && meanScores(key_size, true) <= threshold)
+            return key_size;
+
+    return best.key_size;
+}
+
+size_t likelyKeySizeByAutocorrelation(const ByteArray& cipher, size_t min_key_size, size_t max_key_size){
+    return likelyKeySizeFromScores(autocorrelationByKeySize(cipher, min_key_size, max_key_size));
+}
+
+struct RepeatingXorResult{
+    std::string key;
+    double score;
+    std::string plain_text;
+};
+
+RepeatingXorResult breakRepeatingKeyXor(
+        const ByteArray& cipher, size_t min_key_size, size_t max_key_size, size_t key_sizes_to_try){
+    assert(cipher.numBytes() > 0);
+
+    //The autocorrelation picks use the whole ciphertext, so they lead. The divisor pick can undershoot,
+    //   so the best shift itself is always tried beside it.
+    std::vector<size_t> key_sizes;
+    std::vector<KeySizeScore> scores = autocorrelationByKeySize(cipher, min_key_size, max_key_size);
+    if(!scores.empty()){
+        key_sizes.push_back(likelyKeySizeFromScores(scores));
+        const size_t best_shift = lowestScore(scores).key_size;
+        if(best_shift != key_sizes.front()) key_sizes.push_back(best_shift);
+    }
+    const size_t n_picks = key_sizes.size();
+
+    //Ranked sizes fill in the rest. A multiple of a ranked size can reproduce that key with freedom to spare
+    //   and would win on overfitting alone, so multiples of ranked sizes already queued are skipped.
+    auto queueRanked = [&key_sizes, n_picks](size_t key_size){
+        for(size_t i = 0; i < key_sizes.size(); i++)
+            if(i < n_picks ? key_size == key_sizes[i] : key_size % key_sizes[i] == 0) return;
+        key_sizes.push_back(key_size);
+    };
+
+    //The Hamming ranking is quadratic in the key size, so it only covers short keys; the sorted shift scores cover the rest
+    static constexpr size_t HAMMING_MAX_KEY_SIZE = 40;
+    for(const KeySizeScore& score : rankKeySizesByHamming(cipher, min_key_size, std::min(max_key_size, HAMMING_MAX_KEY_SIZE)))
+        queueRanked(score.key_size);
+    std::sort(
+        scores.begin(),
+        scores.end(),
+        [](const KeySizeScore& a, const KeySizeScore& b){return a.normalised_edit_distance < b.normalised_edit_distance;}
+    );
+    for(const KeySizeScore& score : scores){
+        if(key_sizes.size() >= key_sizes_to_try) break;
+        queueRanked(score.key_size);
+    }
+
+    RepeatingXorResult result = {.key = {}, .score = std::numeric_limits<double>::max(), .plain_text = {}};
+    for(size_t i = 0; i < key_sizes.size() && i < key_sizes_to_try; i++){
+        std::string guessed_key = cipher.bestRepeatingXorKey(key_sizes[i]);
+        ByteArray decrypted = cipher;
+        decrypted.applyRepeatingKeyXor(guessed_key);
+        std::string resulting_msg = decrypted.toAscii();
+
+        //A divisor of the best size so far decrypts at least as well if it is the real key size, so it wins ties
+        double score = l1Score(resulting_msg);
+        if(score < result.score || (score == result.score && result.key.size() % guessed_key.size() == 0)){
+            result.score = score;
+            result.key = std::move(guessed_key);
+            result.plain_text = std::move(resulting_msg);
+        }
+    }
+
+    //A key recovered at a multiple of its size comes back as near copies, the spare freedom overfitting a few bytes.
+    //   If most bytes repeat with a shorter period, that is the key size; solving it again pools each byte's columns.
+    for(size_t period = min_key_size; period < result.key.size(); period++){
+        if(result.key.size() % period) continue;
+        size_t repeats = 0;
+        for(size_t i = period; i < result.key.size(); i++)
+            repeats += result.key[i] == result.key[i - period];
+        if(2*repeats < result.key.size() - period) continue;
+
+        result.key = cipher.bestRepeatingXorKey(period);
+        ByteArray decrypted = cipher;
+        decrypted.applyRepeatingKeyXor(result.key);
+        result.plain_text = decrypted.toAscii();
+        result.score = l1Score(result.plain_text);
+        break;
+    }
+
+    return result;
+}
+
+size_t repeatedBlocks(std::string_view bytes, size_t block_size){
+    //ECB maps equal plaintext blocks to equal ciphertext blocks, so repeats are a strong tell
+    assert(block_size > 0);
+    std::unordered_set<std::string_view> seen;
+    size_t repeats = 0;
+    for(size_t i = 0; i + block_size <= bytes.size(); i += block_size)
+        repeats += !seen.insert(bytes.substr(i, block_size)).second;
+
+    return repeats;
+}
+
+}
+
+#endif // ANALYSIS_H
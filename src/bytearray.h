@@ -2,9 +2,13 @@
 #define BYTEARRAY_H
 
 #include "base64.h"
+#include "cpu_dispatch.h"
 #include "hex.h"
+#include "small_vector.h"
 #include "text_frequency_analysis.h"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <string>
 #include <vector>
@@ -32,8 +36,12 @@ private:
     //The vector is ordered from the least significant bits at the front to the most significant in the back
     //After an operation:
     //   The vector will have unused space. unusedBits() is never 0.
+    //The first INLINE_WORDS words live inside the object, so short arrays such as an AES block
+    //   or a line of hex never touch the heap. With the spare word, that is up to 63 bytes.
 
-    std::vector<size_t> data = {0};
+    static constexpr size_t INLINE_WORDS = 64 / BYTES_PER_WORD;
+    typedef SmallVector<size_t, INLINE_WORDS> Words;
+    Words data = {0};
     uint8_t used_bits = 0;
     uint8_t usedBitsInLastWord() const noexcept { return used_bits; }
     uint8_t unusedBitsInLastWord() const noexcept { return BITS_PER_WORD - used_bits; }
@@ -52,6 +60,15 @@ private:
 
     uint8_t padding_front = 0; //EVENTUALLY: this is a terrible hack. Make a better design for base64.
 
+    //The byte kernels see the words as raw memory, which is only in byte order on little-endian targets
+    static constexpr bool BYTES_IN_WORD_ORDER = std::endian::native == std::endian::little;
+    uint8_t* rawBytes() noexcept { return reinterpret_cast<uint8_t*>(data.data()); }
+    const uint8_t* rawBytes() const noexcept { return reinterpret_cast<const uint8_t*>(data.data()); }
+    void resizeBytes(size_t n_bytes){
+        data.assign(n_bytes / BYTES_PER_WORD + 1, 0);
+        setUsedBitsInLastWord(static_cast<uint8_t>((n_bytes % BYTES_PER_WORD) * BITS_PER_BYTE));
+    }
+
 public:
     size_t numBits() const noexcept{
         return allocatedBits() - unusedBitsInLastWord();
@@ -150,6 +167,12 @@ public:
 
     static ByteArray fromHexString(std::string_view str){
         ByteArray array;
+        if(BYTES_IN_WORD_ORDER && str.size() % 2 == 0){
+            array.resizeBytes(str.size() / 2);
+            kernels().hex_decode_reversed(str.data(), str.size() / 2, array.rawBytes());
+            return array;
+        }
+
         for(size_t i = str.size(); i-->0;){
             uint8_t byte = hexCharToByte(str[i]);
             array.addBits<BITS_PER_HEX_CHAR>(byte);
@@ -161,6 +184,11 @@ public:
     std::string toHexString() const {
         std::string out;
         const size_t total_bits = numBits();
+        if(BYTES_IN_WORD_ORDER && padding_front == 0 && total_bits % BITS_PER_BYTE == 0){
+            out.resize(2*numBytes());
+            kernels().hex_encode_reversed(rawBytes(), numBytes(), out.data());
+            return out;
+        }
         out.reserve(total_bits / BITS_PER_HEX_CHAR);
 
         const size_t offset = total_bits%BITS_PER_HEX_CHAR;
@@ -176,7 +204,39 @@ public:
     }
 
     static ByteArray fromBase64String(std::string_view str){
+        static constexpr size_t CHARS_PER_GROUP = 4;
+        static constexpr size_t BYTES_PER_GROUP = 3;
+
         ByteArray array;
+        std::string unwrapped;
+        if(BYTES_IN_WORD_ORDER && str.find_first_of("\n\r") != std::string_view::npos){
+            //Line breaks carry no bits, so wrapped files can still go through the kernel once they are dropped
+            unwrapped.reserve(str.size());
+            for(char ch : str)
+                if(ch != '\n' && ch != '\r') unwrapped += ch;
+            str = unwrapped;
+        }
+
+        const size_t data_end = str.find_last_not_of('=') + 1;
+        const size_t n_padding = str.size() - data_end;
+        if(BYTES_IN_WORD_ORDER && str.size() % CHARS_PER_GROUP == 0 && n_padding <= 2 && str.find('=') >= data_end){
+            //Whole groups decode in one pass. '=' stands for zero bits, so the padded last group decodes
+            //   as if it were 'A's and lands in the lowest bytes, which padding_front then hides.
+            const size_t n_groups = str.size() / CHARS_PER_GROUP;
+            const size_t n_padded_groups = n_padding ? 1 : 0;
+            array.resizeBytes(BYTES_PER_GROUP * n_groups);
+            kernels().base64_decode_reversed(
+                str.data(), n_groups - n_padded_groups, array.rawBytes() + BYTES_PER_GROUP * n_padded_groups);
+            if(n_padded_groups){
+                char last_group[CHARS_PER_GROUP];
+                std::copy(str.end() - CHARS_PER_GROUP, str.end(), last_group);
+                std::replace(last_group, last_group + CHARS_PER_GROUP, '=', 'A');
+                kernels().base64_decode_reversed(last_group, 1, array.rawBytes());
+                array.padding_front = static_cast<uint8_t>(BITS_PER_BYTE * n_padding);
+            }
+            return array;
+        }
+
         for(size_t i = str.size(); i-->0;){
             if(str[i] == '='){
                 array.addBits<BITS_PER_BASE64_CHAR>(0);
@@ -194,6 +254,13 @@ public:
     std::string toBase64String() const {
         std::string out;
         const size_t total_bits = numBits();
+        static constexpr size_t BITS_PER_GROUP = 24;
+        if(BYTES_IN_WORD_ORDER && total_bits % BITS_PER_GROUP == 0){
+            const size_t n_groups = total_bits / BITS_PER_GROUP;
+            out.resize(4*n_groups);
+            kernels().base64_encode_reversed(rawBytes(), n_groups, out.data());
+            return out;
+        }
         out.reserve(total_bits / BITS_PER_BASE64_CHAR);
 
         const size_t offset = total_bits%BITS_PER_BASE64_CHAR;
@@ -240,9 +307,9 @@ public:
 
         ByteArray out;
         out.setUsedBitsInLastWord(a.usedBitsInLastWord());
-        std::vector<size_t>& out_data = out.data;
-        const std::vector<size_t>& a_data = a.data;
-        const std::vector<size_t>& b_data = b.data;
+        Words& out_data = out.data;
+        const Words& a_data = a.data;
+        const Words& b_data = b.data;
         out_data.resize(a_data.size());
 
         for(size_t i = out_data.size(); i-->0;)
@@ -251,7 +318,22 @@ public:
         return out;
     }
 
-    void applyRepeatingKeyXor(std::string_view keyword) noexcept {
+    void applyRepeatingKeyXor(std::string_view keyword){
+        assert(!keyword.empty());
+        const size_t n_bytes = numBytes();
+        if(BYTES_IN_WORD_ORDER && n_bytes > 0){
+            //Byte i takes keyword[(n_bytes-1-i) % size]; lay that out once as a periodic pattern
+            //  long enough for a full vector load from any phase
+            std::vector<uint8_t> pattern(keyword.size() + Kernels::MAX_VECTOR_BYTES);
+            size_t index = (n_bytes-1) % keyword.size();
+            for(uint8_t& key_byte : pattern){
+                key_byte = static_cast<uint8_t>(keyword[index]);
+                index = (index == 0 ? keyword.size() : index) - 1;
+            }
+            kernels().xor_pattern(rawBytes(), n_bytes, pattern.data(), keyword.size());
+            return;
+        }
+
         size_t index = 0;
         for(size_t i = numBytes(); i-->0;){
             uint8_t byte = getByte(i);
@@ -263,16 +345,8 @@ public:
 
     static size_t differingBits(const ByteArray& a, const ByteArray& b) noexcept {
         //aka Hamming distance
-        size_t differing_bits = 0;
-        const std::vector<size_t>& a_data = a.data;
-        const std::vector<size_t>& b_data = b.data;
-        for(size_t i = 0; i < a_data.size(); i++){
-            const size_t diff = a_data[i] ^ b_data[i];
-            for(uint8_t j = 0; j < BITS_PER_WORD; j++)
-                differing_bits += isBitSet(diff, j);
-        }
-
-        return differing_bits;
+        assert(a.data.size() == b.data.size());
+        return kernels().differing_bits(a.data.data(), b.data.data(), a.data.size());
     }
 
     double scoreGuess(size_t start, size_t offset, uint8_t guess) const noexcept {
@@ -0,0 +1,155 @@
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+#include "kernels.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace CryptoFriends {
+
+//One binary runs on a mixed fleet, so the hot kernels are bound to the best implementation
+//  the CPU supports the first time they are needed.
+//Set CRYPTOFRIENDS_ISA=scalar|sse2|avx2|avx512 or call forceIsa() to pin a lower tier for benchmarking
+//  and differential testing. Requests above what the CPU supports are clamped.
+
+enum class Isa : uint8_t {
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512,
+};
+
+static constexpr Isa ALL_ISAS[] = {Isa::Scalar, Isa::Sse2, Isa::Avx2, Isa::Avx512};
+
+constexpr std::string_view isaName(Isa isa) noexcept {
+    switch(isa){
+        case Isa::Scalar: return "scalar";
+        case Isa::Sse2: return "sse2";
+        case Isa::Avx2: return "avx2";
+        case Isa::Avx512: return "avx512";
+    }
+    return "scalar";
+}
+
+struct KernelTable{
+    Isa isa;
+    void (*xor_pattern)(uint8_t* bytes, size_t n_bytes, const uint8_t* pattern, size_t period) noexcept;
+    size_t (*differing_bits)(const size_t* a, const size_t* b, size_t n_words) noexcept;
+    void (*hex_decode_reversed)(const char* in, size_t n_bytes, uint8_t* out) noexcept;
+    void (*hex_encode_reversed)(const uint8_t* in, size_t n_bytes, char* out) noexcept;
+    void (*base64_decode_reversed)(const char* in, size_t n_groups, uint8_t* out) noexcept;
+    void (*base64_encode_reversed)(const uint8_t* in, size_t n_groups, char* out) noexcept;
+    double (*l1_distance)(const double* a, const double* b, size_t n) noexcept;
+};
+
+//Tiers without a dedicated version of a kernel reuse the best lower tier's
+static constexpr KernelTable SCALAR_KERNELS = {
+    .isa = Isa::Scalar,
+    .xor_pattern = Kernels::xorPatternScalar,
+    .differing_bits = Kernels::differingBitsScalar,
+    .hex_decode_reversed = Kernels::hexDecodeReversedScalar,
+    .hex_encode_reversed = Kernels::hexEncodeReversedScalar,
+    .base64_decode_reversed = Kernels::base64DecodeReversedScalar,
+    .base64_encode_reversed = Kernels::base64EncodeReversedScalar,
+    .l1_distance = Kernels::l1DistanceScalar,
+};
+
+#ifdef CRYPTOFRIENDS_X86_KERNELS
+static constexpr KernelTable SSE2_KERNELS = {
+    .isa = Isa::Sse2,
+    .xor_pattern = Kernels::xorPatternSse2,
+    .differing_bits = Kernels::differingBitsSse2,
+    .hex_decode_reversed = Kernels::hexDecodeReversedSse2,
+    .hex_encode_reversed = Kernels::hexEncodeReversedSse2,
+    .base64_decode_reversed = Kernels::base64DecodeReversedScalar,
+    .base64_encode_reversed = Kernels::base64EncodeReversedScalar,
+    .l1_distance = Kernels::l1DistanceSse2,
+};
+
+static constexpr KernelTable AVX2_KERNELS = {
+    .isa = Isa::Avx2,
+    .xor_pattern = Kernels::xorPatternAvx2,
+    .differing_bits = Kernels::differingBitsAvx2,
+    .hex_decode_reversed = Kernels::hexDecodeReversedAvx2,
+    .hex_encode_reversed = Kernels::hexEncodeReversedSse2,
+    .base64_decode_reversed = Kernels::base64DecodeReversedScalar,
+    .base64_encode_reversed = Kernels::base64EncodeReversedScalar,
+    .l1_distance = Kernels::l1DistanceAvx2,
+};
+
+static constexpr KernelTable AVX512_KERNELS = {
+    .isa = Isa::Avx512,
+    .xor_pattern = Kernels::xorPatternAvx512,
+    .differing_bits = Kernels::differingBitsAvx512,
+    .hex_decode_reversed = Kernels::hexDecodeReversedAvx2,
+    .hex_encode_reversed = Kernels::hexEncodeReversedSse2,
+    .base64_decode_reversed = Kernels::base64DecodeReversedScalar,
+    .base64_encode_reversed = Kernels::base64EncodeReversedScalar,
+    .l1_distance = Kernels::l1DistanceAvx512,
+};
+#endif
+
+Isa detectIsa() noexcept {
+    #ifdef CRYPTOFRIENDS_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return Isa::Avx512;
+    if(__builtin_cpu_supports("avx2")) return Isa::Avx2;
+    if(__builtin_cpu_supports("sse2")) return Isa::Sse2;
+    #endif
+    return Isa::Scalar;
+}
+
+const KernelTable& kernelsFor(Isa isa) noexcept {
+    if(isa > detectIsa()) isa = detectIsa();
+
+    #ifdef CRYPTOFRIENDS_X86_KERNELS
+    switch(isa){
+        case Isa::Avx512: return AVX512_KERNELS;
+        case Isa::Avx2: return AVX2_KERNELS;
+        case Isa::Sse2: return SSE2_KERNELS;
+        case Isa::Scalar: break;
+    }
+    #endif
+    return SCALAR_KERNELS;
+}
+
+Isa startupIsa() noexcept {
+    const char* env = std::getenv("CRYPTOFRIENDS_ISA");
+    if(env){
+        for(Isa isa : ALL_ISAS)
+            if(isaName(isa) == env) return isa;
+
+        //A mistyped override would otherwise benchmark the detected tier without saying so
+        std::fprintf(stderr, "cryptofriends: ignoring unknown CRYPTOFRIENDS_ISA=%s, expected one of", env);
+        for(Isa isa : ALL_ISAS) std::fprintf(stderr, " %s", isaName(isa).data());
+        std::fputc('\n', stderr);
+    }
+
+    return detectIsa();
+}
+
+std::atomic<const KernelTable*>& boundKernels() noexcept {
+    static std::atomic<const KernelTable*> bound = &kernelsFor(startupIsa());
+    return bound;
+}
+
+const KernelTable& kernels() noexcept {
+    return *boundKernels().load(std::memory_order_relaxed);
+}
+
+Isa activeIsa() noexcept {
+    return kernels().isa;
+}
+
+Isa forceIsa(Isa isa) noexcept {
+    const KernelTable& table = kernelsFor(isa);
+    boundKernels().store(&table, std::memory_order_relaxed);
+    return table.isa;
+}
+
+}
+
+#endif // CPU_DISPATCH_H
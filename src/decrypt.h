@@ -9,6 +9,8 @@
 #include <openssl/rsa.h>
 #include <openssl/pem.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
 
 namespace CryptoFriends {
 
@@ -33,6 +35,56 @@ std::string decrypt(const std::string& encryped_src, std::string_view key){
     return strRet;
 }
 
+std::string encrypt(std::string_view plain_src, std::string_view key){
+    //ECB over every block in one call, so a caller can batch many blocks into a single request.
+    //Padding is the caller's job, so the EVP cipher's own padding is switched off.
+    assert(plain_src.length() % AES_BLOCK_SIZE == 0);
+
+    const EVP_CIPHER* cipher = nullptr;
+    switch (key.length()){
+        case 16: cipher = EVP_aes_128_ecb(); break;
+        case 24: cipher = EVP_aes_192_ecb(); break;
+        case 32: cipher = EVP_aes_256_ecb(); break;
+    }
+    assert(cipher);
+
+    std::string strRet;
+    strRet.resize(plain_src.length());
+    int n_update = 0;
+    int n_final = 0;
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    const bool ok = ctx
+        && EVP_EncryptInit_ex(ctx, cipher, nullptr, (const unsigned char*)key.data(), nullptr) == 1
+        && EVP_CIPHER_CTX_set_padding(ctx, 0) == 1
+        && EVP_EncryptUpdate(ctx, (unsigned char*)strRet.data(), &n_update,
+                             (const unsigned char*)plain_src.data(), static_cast<int>(plain_src.length())) == 1
+        && EVP_EncryptFinal_ex(ctx, (unsigned char*)strRet.data() + n_update, &n_final) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    if (!ok || static_cast<size_t>(n_update + n_final) != plain_src.length())
+        assert(false);
+
+    return strRet;
+}
+
+std::string pkcs7Pad(std::string_view src, size_t block_size = AES_BLOCK_SIZE){
+    assert(block_size > 0 && block_size <= 255);
+    const size_t n_pad = block_size - src.length() % block_size;
+    std::string out(src);
+    out.append(n_pad, static_cast<char>(n_pad));
+
+    return out;
+}
+
+std::string randomBytes(size_t n_bytes){
+    std::string out;
+    out.resize(n_bytes);
+    if (RAND_bytes((unsigned char*)out.data(), static_cast<int>(n_bytes)) != 1)
+        assert(false);
+
+    return out;
+}
+
 }
 
 #endif // DECRYPT_H
@@ -0,0 +1,118 @@
+#ifndef ECB_ORACLE_H
+#define ECB_ORACLE_H
+
+#include "decrypt.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace CryptoFriends {
+
+class EcbOracle{
+
+private:
+    //Encrypts attacker-controlled bytes followed by a secret suffix under a fixed, random key:
+    //   AES-128-ECB(attacker_input || secret, key)
+    //The oracle is local and in-process, so the number of calls is the cost that matters to the attack.
+
+    const std::string key;
+    const std::string secret;
+    mutable size_t n_calls = 0;
+
+public:
+    static constexpr size_t KEY_SIZE = 16;
+
+    EcbOracle(std::string_view secret)
+        : key(randomBytes(KEY_SIZE)), secret(secret) {}
+
+    std::string operator()(std::string_view attacker_input) const {
+        n_calls++;
+        std::string plain_text;
+        plain_text.reserve(attacker_input.size() + secret.size() + AES_BLOCK_SIZE);
+        plain_text += attacker_input;
+        plain_text += secret;
+        return encrypt(pkcs7Pad(plain_text), key);
+    }
+
+    size_t numCalls() const noexcept { return n_calls; }
+};
+
+template<typename Oracle> size_t detectBlockSize(Oracle&& oracle, size_t* secret_size = nullptr){
+    //Grow the input until the ciphertext spills into a new block.
+    //The size of the jump is the block size, and the input length at the jump pins down the suffix length.
+    const size_t base_size = oracle(std::string_view()).size();
+    std::string input;
+    for(;;){
+        input += 'A';
+        const size_t size = oracle(input).size();
+        if(size == base_size) continue;
+
+        if(secret_size) *secret_size = base_size - input.size();
+        return size - base_size;
+    }
+}
+
+template<typename Oracle> std::string byteAtATimeEcbDecrypt(Oracle&& oracle){
+    //Recovers the secret suffix of an ECB oracle one byte at a time.
+    //Each query carries the 256 candidate blocks for the next byte ahead of the alignment prefix,
+    //  so a single multi-block encryption both builds the dictionary and produces the target block.
+    //  Candidates are block-aligned, so they don't shift the alignment of the prefix and secret behind them.
+    size_t secret_size;
+    const size_t block_size = detectBlockSize(oracle, &secret_size);
+    assert(block_size > 1);
+
+    static constexpr size_t N_CANDIDATES = 256;
+    const size_t dictionary_size = N_CANDIDATES * block_size;
+
+    std::string recovered;
+    recovered.reserve(secret_size);
+
+    std::string query;
+    query.resize(dictionary_size + block_size - 1);
+
+    std::unordered_map<std::string_view, uint8_t> dictionary;
+    dictionary.reserve(N_CANDIDATES);
+
+    while(recovered.size() < secret_size){
+        //Known window is the last block_size-1 bytes of 'A'-padding followed by what is recovered so far
+        const size_t n_known = block_size - 1;
+        char* window = query.data();
+        for(size_t i = 0; i < n_known; i++){
+            const size_t from_end = n_known - i;
+            window[i] = from_end <= recovered.size() ? recovered[recovered.size() - from_end] : 'A';
+        }
+        for(size_t candidate = 1; candidate < N_CANDIDATES; candidate++)
+            std::copy(window, window + n_known, query.data() + candidate*block_size);
+        for(size_t candidate = 0; candidate < N_CANDIDATES; candidate++)
+            query[candidate*block_size + n_known] = static_cast<char>(candidate);
+
+        const size_t prefix_size = n_known - (recovered.size() % block_size);
+        query.resize(dictionary_size + prefix_size);
+        std::fill(query.begin() + dictionary_size, query.end(), 'A');
+
+        const std::string cipher_text = oracle(query);
+
+        dictionary.clear();
+        for(size_t candidate = 0; candidate < N_CANDIDATES; candidate++){
+            std::string_view block(cipher_text.data() + candidate*block_size, block_size);
+            dictionary.emplace(block, static_cast<uint8_t>(candidate));
+        }
+
+        const size_t target_offset = dictionary_size + (recovered.size() / block_size) * block_size;
+        assert(target_offset + block_size <= cipher_text.size());
+        auto match = dictionary.find(std::string_view(cipher_text.data() + target_offset, block_size));
+        if(match == dictionary.end()) break;
+        recovered += static_cast<char>(match->second);
+
+        query.resize(dictionary_size + block_size - 1);
+    }
+
+    return recovered;
+}
+
+}
+
+#endif // ECB_ORACLE_H
@@ -0,0 +1,77 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <cassert>
+#include <complex>
+#include <numbers>
+#include <vector>
+
+namespace CryptoFriends {
+
+typedef std::vector<std::complex<double>> ComplexSignal;
+
+class Fft{
+
+private:
+    //Iterative radix-2 Cooley-Tukey for one power-of-two size, transforming in place.
+    //Roots of unity are computed directly rather than by repeated multiplication to keep long transforms accurate.
+    //   Each stage's roots are stored together at [len/2, len) so the butterflies read them sequentially.
+
+    const size_t n;
+    ComplexSignal roots;
+
+public:
+    explicit Fft(size_t n)
+        : n(n), roots(n) {
+        assert(n > 0 && (n & (n-1)) == 0);
+        for(size_t len = 2; len <= n; len <<= 1)
+            for(size_t k = 0; k < len/2; k++)
+                roots[len/2 + k] = std::polar(1.0, -2 * std::numbers::pi * k / len);
+    }
+
+    size_t size() const noexcept { return n; }
+
+    void forward(ComplexSignal& signal) const noexcept {
+        assert(signal.size() == n);
+
+        for(size_t i = 1, j = 0; i < n; i++){
+            size_t bit = n >> 1;
+            for(; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if(i < j) std::swap(signal[i], signal[j]);
+        }
+
+        //Butterflies work on the interleaved doubles directly; going through std::complex
+        //   is several times slower here, as its operator* takes a NaN-checking library path
+        double* values = reinterpret_cast<double*>(signal.data());
+        const double* root_values = reinterpret_cast<const double*>(roots.data());
+        for(size_t len = 2; len <= n; len <<= 1){
+            const double* w = root_values + len;
+            for(size_t start = 0; start < n; start += len){
+                double* even = values + 2*start;
+                double* odd = even + len;
+                for(size_t k = 0; k < len/2; k++){
+                    const double re = odd[2*k]*w[2*k] - odd[2*k+1]*w[2*k+1];
+                    const double im = odd[2*k]*w[2*k+1] + odd[2*k+1]*w[2*k];
+                    const double even_re = even[2*k];
+                    const double even_im = even[2*k+1];
+                    even[2*k] = even_re + re;
+                    even[2*k+1] = even_im + im;
+                    odd[2*k] = even_re - re;
+                    odd[2*k+1] = even_im - im;
+                }
+            }
+        }
+    }
+
+    void inverse(ComplexSignal& signal) const noexcept {
+        //Unscaled; conjugating around the forward transform reuses its roots
+        for(std::complex<double>& x : signal) x = std::conj(x);
+        forward(signal);
+        for(std::complex<double>& x : signal) x = std::conj(x);
+    }
+};
+
+}
+
+#endif // FFT_H
@@ -0,0 +1,272 @@
+//CODEGEN FILE
+
+#ifndef CRYPTOFRIENDS_FREQUENCY_TABLE_H
+#define CRYPTOFRIENDS_FREQUENCY_TABLE_H
+
+#include <array>
+
+namespace CryptoFriends {
+
+typedef std::array<double, 256> Frequency;
+extern constexpr Frequency FREQUENCY_MAP = {
+             0,
+             0,
+             0,
+             0,
+             4.37410877533702545014431678493949107178195845335721969604492e-06,
+             0,
+             0,
+             0,
+             0,
+    /* \t */ 0,
+    /* \n */ 0,
+             0,
+             0,
+    /* \r */ 0.0206971891977009679608467962452778010629117488861083984375,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+    /*    */ 0.2233419940687084992436695074502495117485523223876953125,
+    /* !  */ 0.000804836014662012560853809883809617531369440257549285888671875,
+    /* "  */ 4.81151965287072782575215901257337236529565416276454925537109e-05,
+    /* #  */ 3.28058158150276866409176396155444876967521850019693374633789e-06,
+    /* $  */ 4.37410877533702545014431678493949107178195845335721969604492e-06,
+    /* %  */ 2.18705438766851272507215839246974553589097922667860984802246e-06,
+    /* &  */ 1.09352719383425636253607919623487276794548961333930492401123e-06,
+    /* '  */ 8.74821755067405022266227576643871088890591636300086975097656e-05,
+    /* (  */ 5.68634140793813257696784346784113495232304558157920837402344e-05,
+    /* )  */ 5.68634140793813257696784346784113495232304558157920837402344e-05,
+    /* *  */ 5.13957781102100452275474595786874942859867587685585021972656e-05,
+    /* +  */ 0,
+    /* ,  */ 0.01168871217489436502290356401090321014635264873504638671875,
+    /* -  */ 0.00064190046278070843864538286283050183556042611598968505859375,
+    /* .  */ 0.01042022063004662858765048127906993613578379154205322265625,
+    /* /  */ 1.96834894890166119845505837693266926180513110011816024780273e-05,
+    /* 0  */ 5.7956941273215579167599198484595035552047193050384521484375e-05,
+    /* 1  */ 0.000178244932594983778199534962816130700957728549838066101074219,
+    /* 2  */ 6.451810443622112666017809345930800191126763820648193359375e-05,
+    /* 3  */ 6.56116316300553800580988572654916879400843754410743713378906e-05,
+    /* 4  */ 7.43598491807294207939921237837666012637782841920852661132812e-05,
+    /* 5  */ 5.90504684670498393417835403251814341274439357221126556396484e-05,
+    /* 6  */ 3.71799245903647103969960618918833006318891420960426330566406e-05,
+    /* 7  */ 2.40575982643536391287607950628668618264782708138227462768555e-05,
+    /* 8  */ 4.92087237225415316554423539319174096817732788622379302978516e-05,
+    /* 9  */ 4.04605061718674841432855093792397838114993646740913391113281e-05,
+    /* :  */ 0.00017277729662581249765740398771640684572048485279083251953125,
+    /* ;  */ 0.0017310535478396275876900034518257598392665386199951171875,
+    /* <  */ 0,
+    /* =  */ 0,
+    /* >  */ 0,
+    /* ?  */ 0.000800461905886675601472235452860104487626813352108001708984375,
+    /* @  */ 0,
+    /* A  */ 0.0017266794390642906283084290208762467955239117145538330078125,
+    /* B  */ 0.00163591668197604731167793534751808692817576229572296142578125,
+    /* C  */ 0.0018141616145710311169825246224718284793198108673095703125,
+    /* D  */ 0.00097761331128782516693143112007646777783520519733428955078125,
+    /* E  */ 0.0020470829068577277819185322726980302832089364528656005859375,
+    /* F  */ 0.000365238082740641583582436036081730890145990997552871704101562,
+    /* G  */ 0.000926217533177615026836193568016142307897098362445831298828125,
+    /* H  */ 0.000959023348992642764299088042889707139693200588226318359375,
+    /* I  */ 0.0044583103692622631786246500951165216974914073944091796875,
+    /* J  */ 0.00070423151282926108561477374081505331560038030147552490234375,
+    /* K  */ 0.000453813785441216366312033869689912535250186920166015625,
+    /* L  */ 0.00190492437165927443361301829582998834666796028614044189453125,
+    /* M  */ 0.002403572772047695392527710822605513385497033596038818359375,
+    /* N  */ 0.0012531821641340577279388757148126387619413435459136962890625,
+    /* O  */ 0.000789526633948332986177864878385435076779685914516448974609375,
+    /* P  */ 0.000617842864516354836786071746956849892740137875080108642578125,
+    /* Q  */ 9.84174474450830599227529188466334630902565550059080123901367e-06,
+    /* R  */ 0.0007064185672169295653055609562898098374716937541961669921875,
+    /* S  */ 0.00105416021485622304031115614719738005078397691249847412109375,
+    /* T  */ 0.00142377240637220174590549248705428908579051494598388671875,
+    /* U  */ 0.00022417307473602252933242429122628891491331160068511962890625,
+    /* V  */ 6.01439956608840927397043041313651201562606729567050933837891e-05,
+    /* W  */ 0.0011077430473541015516769636661820186418481171131134033203125,
+    /* X  */ 4.37410877533702545014431678493949107178195845335721969604492e-06,
+    /* Y  */ 0.00090762757088243273262406773937982507050037384033203125,
+    /* Z  */ 4.37410877533702545014431678493949107178195845335721969604492e-06,
+    /* [  */ 0.000357583392383801796244463533369639662851113826036453247070312,
+    /* \  */ 0,
+    /* ]  */ 0.000357583392383801796244463533369639662851113826036453247070312,
+    /* ^  */ 0,
+    /* _  */ 0.00103447672536720650625363671082368455245159566402435302734375,
+    /* `  */ 0,
+    /* a  */ 0.054523265884576017914486811832830426283180713653564453125,
+    /* b  */ 0.0105962785082539430459025453501453739590942859649658203125,
+    /* c  */ 0.017476751611859082935485076859549735672771930694580078125,
+    /* d  */ 0.028006324961289137676079263883366365917026996612548828125,
+    /* e  */ 0.08986169068052383968048246742910123430192470550537109375,
+    /* f  */ 0.0153881146716356546899628909841339918784797191619873046875,
+    /* g  */ 0.013194499120804135949835966812315746210515499114990234375,
+    /* h  */ 0.04206142998364083285256498356829979456961154937744140625,
+    /* i  */ 0.04639507825280599073725085190744721330702304840087890625,
+    /* j  */ 0.000844202993640045845809283253657895329524762928485870361328125,
+    /* k  */ 0.004585159523747036301732915575257720774970948696136474609375,
+    /* l  */ 0.0278433894094078336622910541109376936219632625579833984375,
+    /* m  */ 0.0173969241267091824509893882577671320177614688873291015625,
+    /* n  */ 0.04968878216063477015751459475723095238208770751953125,
+    /* o  */ 0.0537632644848612117893793538314639590680599212646484375,
+    /* p  */ 0.01094073957431173325927087347508859238587319850921630859375,
+    /* q  */ 0.0008299871401202005109787318559710911358706653118133544921875,
+    /* r  */ 0.04335288559955909060139589428217732347548007965087890625,
+    /* s  */ 0.042621315906883970592300414637065841816365718841552734375,
+    /* t  */ 0.061162069478343787654051055824311333708465099334716796875,
+    /* u  */ 0.0206359516748462513968664922003881656564772129058837890625,
+    /* v  */ 0.007473164842663307209924550278401511604897677898406982421875,
+    /* w  */ 0.015014128371344338808146545716226682998239994049072265625,
+    /* x  */ 0.0011591388254643115833519839696919007110409438610076904296875,
+    /* y  */ 0.0170644918597835683338193035751828574575483798980712890625,
+    /* z  */ 0.00103994436133637781390082199806101925787515938282012939453125,
+    /* {  */ 0,
+    /* |  */ 0,
+    /* }  */ 0,
+    /* ~  */ 0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             2.73381798458564060987866645158206324595084879547357559204102e-05,
+             0.00113508122719995808991289010236869216896593570709228515625,
+             0.00195960073135098729324443667110244859941303730010986328125,
+             0.00190383084446544008534740743954216668498702347278594970703125,
+             0,
+             0,
+             0.000463655530185724633340793587876760284416377544403076171875,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             4.37410877533702545014431678493949107178195845335721969604492e-06,
+             0,
+             0,
+             0,
+             0,
+             0,
+             2.18705438766851272507215839246974553589097922667860984802246e-06,
+             0,
+             0,
+             1.09352719383425636253607919623487276794548961333930492401123e-06,
+             8.74821755067405090028863356987898214356391690671443939208984e-06,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+             0,
+};
+
+} // namespace CryptoFriends
+
+#endif // CRYPTOFRIENDS_FREQUENCY_TABLE_H
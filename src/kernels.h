@@ -0,0 +1,364 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "base64.h"
+#include "hex.h"
+
+#include <array>
+#include <bit>
+#include <cinttypes>
+#include <cmath>
+#include <cstddef>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CRYPTOFRIENDS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace CryptoFriends {
+
+namespace Kernels {
+
+//Byte-oriented kernels work on raw memory in ByteArray order, i.e. byte 0 is the last byte of the text.
+//  The "Reversed" codecs translate between that order and the text order of an encoded string.
+//Every kernel has a portable scalar version; the x86 versions are bound at runtime by cpu_dispatch.h.
+
+static constexpr size_t MAX_VECTOR_BYTES = 64;
+
+//bytes[i] ^= pattern[i % period], where pattern holds at least period + MAX_VECTOR_BYTES bytes
+void xorPatternScalar(uint8_t* bytes, size_t n_bytes, const uint8_t* pattern, size_t period) noexcept {
+    size_t phase = 0;
+    for(size_t i = 0; i < n_bytes; i++){
+        bytes[i] ^= pattern[phase];
+        if(++phase == period) phase = 0;
+    }
+}
+
+size_t differingBitsScalar(const size_t* a, const size_t* b, size_t n_words) noexcept {
+    size_t differing_bits = 0;
+    for(size_t i = 0; i < n_words; i++)
+        differing_bits += std::popcount(a[i] ^ b[i]);
+
+    return differing_bits;
+}
+
+void hexDecodeReversedScalar(const char* in, size_t n_bytes, uint8_t* out) noexcept {
+    for(size_t k = 0; k < n_bytes; k++)
+        out[n_bytes-1-k] = static_cast<uint8_t>((hexCharToByte(in[2*k]) << BITS_PER_HEX_CHAR) | hexCharToByte(in[2*k+1]));
+}
+
+void hexEncodeReversedScalar(const uint8_t* in, size_t n_bytes, char* out) noexcept {
+    for(size_t k = 0; k < n_bytes; k++){
+        const uint8_t byte = in[n_bytes-1-k];
+        out[2*k] = byteToHexChar(byte >> BITS_PER_HEX_CHAR);
+        out[2*k+1] = byteToHexChar(byte & MAX_HEX_CHAR);
+    }
+}
+
+static constexpr std::array<uint8_t, 256> BASE64_DECODE_TABLE = [](){
+    std::array<uint8_t, 256> table = {0};
+    for(uint8_t i = 0; i < 64; i++) table[static_cast<uint8_t>(byteToBase64Char(i))] = i;
+    return table;
+}();
+
+//Whole 4-char groups only; the caller handles '=' padding
+void base64DecodeReversedScalar(const char* in, size_t n_groups, uint8_t* out) noexcept {
+    const size_t n_bytes = 3*n_groups;
+    for(size_t g = 0; g < n_groups; g++){
+        const uint32_t bits =
+                (BASE64_DECODE_TABLE[static_cast<uint8_t>(in[4*g])] << 18) |
+                (BASE64_DECODE_TABLE[static_cast<uint8_t>(in[4*g+1])] << 12) |
+                (BASE64_DECODE_TABLE[static_cast<uint8_t>(in[4*g+2])] << 6) |
+                BASE64_DECODE_TABLE[static_cast<uint8_t>(in[4*g+3])];
+        out[n_bytes-1-3*g] = static_cast<uint8_t>(bits >> 16);
+        out[n_bytes-2-3*g] = static_cast<uint8_t>(bits >> 8);
+        out[n_bytes-3-3*g] = static_cast<uint8_t>(bits);
+    }
+}
+
+void base64EncodeReversedScalar(const uint8_t* in, size_t n_groups, char* out) noexcept {
+    const size_t n_bytes = 3*n_groups;
+    for(size_t g = 0; g < n_groups; g++){
+        const uint32_t bits =
+                (in[n_bytes-1-3*g] << 16) |
+                (in[n_bytes-2-3*g] << 8) |
+                in[n_bytes-3-3*g];
+        out[4*g] = byteToBase64Char(bits >> 18);
+        out[4*g+1] = byteToBase64Char((bits >> 12) & 63);
+        out[4*g+2] = byteToBase64Char((bits >> 6) & 63);
+        out[4*g+3] = byteToBase64Char(bits & 63);
+    }
+}
+
+//Every tier sums in the same order so scores, and the keys picked by comparing them, match across CPUs:
+//  L1_LANES running sums for the terms at each index mod L1_LANES, folded in halves, then the leftover terms.
+static constexpr size_t L1_LANES = 8;
+
+static inline double l1Fold(const double* lanes) noexcept {
+    const double t0 = lanes[0] + lanes[4];
+    const double t1 = lanes[1] + lanes[5];
+    const double t2 = lanes[2] + lanes[6];
+    const double t3 = lanes[3] + lanes[7];
+    return (t0 + t2) + (t1 + t3);
+}
+
+static inline double l1Tail(const double* a, const double* b, size_t i, size_t n, double residual) noexcept {
+    for(; i < n; i++)
+        //if(a[i] > 0 && b[i] == 0) residual += 0.5; else
+        residual += std::abs(a[i] - b[i]);
+
+    return residual;
+}
+
+double l1DistanceScalar(const double* a, const double* b, size_t n) noexcept {
+    double lanes[L1_LANES] = {};
+    size_t i = 0;
+    for(; i + L1_LANES <= n; i += L1_LANES)
+        for(size_t lane = 0; lane < L1_LANES; lane++)
+            lanes[lane] += std::abs(a[i+lane] - b[i+lane]);
+
+    return l1Tail(a, b, i, n, l1Fold(lanes));
+}
+
+#ifdef CRYPTOFRIENDS_X86_KERNELS
+
+__attribute__((target("sse2"))) static inline __m128i reverseBytesSse2(__m128i x) noexcept {
+    x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+    x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+__attribute__((target("sse2")))
+void xorPatternSse2(uint8_t* bytes, size_t n_bytes, const uint8_t* pattern, size_t period) noexcept {
+    size_t i = 0;
+    size_t phase = 0;
+    for(; i + 16 <= n_bytes; i += 16){
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        const __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + phase));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + i), _mm_xor_si128(x, k));
+        phase = (phase + 16) % period;
+    }
+    xorPatternScalar(bytes + i, n_bytes - i, pattern + phase, period);
+}
+
+__attribute__((target("avx2")))
+void xorPatternAvx2(uint8_t* bytes, size_t n_bytes, const uint8_t* pattern, size_t period) noexcept {
+    size_t i = 0;
+    size_t phase = 0;
+    for(; i + 32 <= n_bytes; i += 32){
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+        const __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern + phase));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes + i), _mm256_xor_si256(x, k));
+        phase = (phase + 32) % period;
+    }
+    xorPatternScalar(bytes + i, n_bytes - i, pattern + phase, period);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+void xorPatternAvx512(uint8_t* bytes, size_t n_bytes, const uint8_t* pattern, size_t period) noexcept {
+    size_t i = 0;
+    size_t phase = 0;
+    for(; i + 64 <= n_bytes; i += 64){
+        const __m512i x = _mm512_loadu_si512(bytes + i);
+        const __m512i k = _mm512_loadu_si512(pattern + phase);
+        _mm512_storeu_si512(bytes + i, _mm512_xor_si512(x, k));
+        phase = (phase + 64) % period;
+    }
+    xorPatternScalar(bytes + i, n_bytes - i, pattern + phase, period);
+}
+
+__attribute__((target("sse2")))
+size_t differingBitsSse2(const size_t* a, const size_t* b, size_t n_words) noexcept {
+    //SWAR popcount per byte, then sum the bytes of each half with psadbw
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0f);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for(; i + 2 <= n_words; i += 2){
+        __m128i v = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi16(v, 1), m1));
+        v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi16(v, 2), m2));
+        v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi16(v, 4)), m4);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+    }
+    const size_t vector_bits =
+            static_cast<size_t>(_mm_cvtsi128_si64(acc)) +
+            static_cast<size_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+
+    return vector_bits + differingBitsScalar(a + i, b + i, n_words - i);
+}
+
+__attribute__((target("avx2")))
+size_t differingBitsAvx2(const size_t* a, const size_t* b, size_t n_words) noexcept {
+    //Nibble lookup through vpshufb, then psadbw to accumulate
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for(; i + 4 <= n_words; i += 4){
+        const __m256i v = _mm256_xor_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        const __m256i lo = _mm256_and_si256(v, low_nibble);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibble);
+        const __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    const __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    const size_t vector_bits =
+            static_cast<size_t>(_mm_cvtsi128_si64(sum)) +
+            static_cast<size_t>(_mm_extract_epi64(sum, 1));
+
+    return vector_bits + differingBitsScalar(a + i, b + i, n_words - i);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t differingBitsAvx512(const size_t* a, const size_t* b, size_t n_words) noexcept {
+    const __m512i lookup = _mm512_broadcast_i32x4(_mm_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i low_nibble = _mm512_set1_epi8(0x0f);
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for(; i + 8 <= n_words; i += 8){
+        const __m512i v = _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        const __m512i lo = _mm512_and_si512(v, low_nibble);
+        const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), low_nibble);
+        const __m512i counts = _mm512_add_epi8(_mm512_shuffle_epi8(lookup, lo), _mm512_shuffle_epi8(lookup, hi));
+        acc = _mm512_add_epi64(acc, _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+    }
+    const size_t vector_bits = static_cast<size_t>(_mm512_reduce_add_epi64(acc));
+
+    return vector_bits + differingBitsScalar(a + i, b + i, n_words - i);
+}
+
+__attribute__((target("sse2"))) static inline __m128i hexNibblesSse2(__m128i chars) noexcept {
+    const __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i is_alpha = _mm_cmpgt_epi8(chars, _mm_set1_epi8('9'));
+    return _mm_sub_epi8(digits, _mm_and_si128(is_alpha, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+__attribute__((target("sse2"))) static inline __m128i hexPairsSse2(__m128i nibbles) noexcept {
+    //Each 16-bit lane holds (high nibble, low nibble) in text order
+    const __m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00ff)), BITS_PER_HEX_CHAR);
+    return _mm_or_si128(high, _mm_srli_epi16(nibbles, 8));
+}
+
+__attribute__((target("sse2")))
+void hexDecodeReversedSse2(const char* in, size_t n_bytes, uint8_t* out) noexcept {
+    size_t k = 0;
+    for(; k + 16 <= n_bytes; k += 16){
+        const __m128i a = hexPairsSse2(hexNibblesSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2*k))));
+        const __m128i b = hexPairsSse2(hexNibblesSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2*k + 16))));
+        const __m128i bytes = reverseBytesSse2(_mm_packus_epi16(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n_bytes - k - 16), bytes);
+    }
+    hexDecodeReversedScalar(in + 2*k, n_bytes - k, out);
+}
+
+__attribute__((target("avx2")))
+void hexDecodeReversedAvx2(const char* in, size_t n_bytes, uint8_t* out) noexcept {
+    const __m256i zero_char = _mm256_set1_epi8('0');
+    const __m256i nine_char = _mm256_set1_epi8('9');
+    const __m256i alpha_adjust = _mm256_set1_epi8('a' - '0' - 10);
+    const __m256i low_byte = _mm256_set1_epi16(0x00ff);
+    const __m256i reverse_qwords = _mm256_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+    auto pairs = [&](__m256i chars) __attribute__((target("avx2"))) {
+        const __m256i is_alpha = _mm256_cmpgt_epi8(chars, nine_char);
+        const __m256i nibbles = _mm256_sub_epi8(_mm256_sub_epi8(chars, zero_char), _mm256_and_si256(is_alpha, alpha_adjust));
+        const __m256i high = _mm256_slli_epi16(_mm256_and_si256(nibbles, low_byte), BITS_PER_HEX_CHAR);
+        return _mm256_or_si256(high, _mm256_srli_epi16(nibbles, 8));
+    };
+
+    size_t k = 0;
+    for(; k + 32 <= n_bytes; k += 32){
+        const __m256i a = pairs(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2*k)));
+        const __m256i b = pairs(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2*k + 32)));
+        //packus interleaves the 128-bit lanes; one qword permute restores text order and reverses it
+        __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(0, 2, 1, 3));
+        bytes = _mm256_shuffle_epi8(bytes, reverse_qwords);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + n_bytes - k - 32), bytes);
+    }
+    hexDecodeReversedSse2(in + 2*k, n_bytes - k, out);
+}
+
+__attribute__((target("sse2")))
+void hexEncodeReversedSse2(const uint8_t* in, size_t n_bytes, char* out) noexcept {
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i alpha_adjust = _mm_set1_epi8('a' - '0' - 10);
+    const __m128i zero_char = _mm_set1_epi8('0');
+    auto toChars = [&](__m128i nibbles) __attribute__((target("sse2"))) {
+        const __m128i is_alpha = _mm_cmpgt_epi8(nibbles, nine);
+        return _mm_add_epi8(_mm_add_epi8(nibbles, zero_char), _mm_and_si128(is_alpha, alpha_adjust));
+    };
+
+    size_t k = 0;
+    for(; k + 16 <= n_bytes; k += 16){
+        const __m128i bytes = reverseBytesSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + n_bytes - k - 16)));
+        const __m128i high = toChars(_mm_and_si128(_mm_srli_epi16(bytes, BITS_PER_HEX_CHAR), low_nibble));
+        const __m128i low = toChars(_mm_and_si128(bytes, low_nibble));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*k), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*k + 16), _mm_unpackhi_epi8(high, low));
+    }
+    hexEncodeReversedScalar(in, n_bytes - k, out + 2*k);
+}
+
+__attribute__((target("sse2")))
+double l1DistanceSse2(const double* a, const double* b, size_t n) noexcept {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d acc[L1_LANES/2] = {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd()};
+    size_t i = 0;
+    for(; i + L1_LANES <= n; i += L1_LANES)
+        for(size_t j = 0; j < L1_LANES/2; j++)
+            acc[j] = _mm_add_pd(acc[j], _mm_andnot_pd(sign, _mm_sub_pd(_mm_loadu_pd(a + i + 2*j), _mm_loadu_pd(b + i + 2*j))));
+
+    double lanes[L1_LANES];
+    for(size_t j = 0; j < L1_LANES/2; j++) _mm_storeu_pd(lanes + 2*j, acc[j]);
+    return l1Tail(a, b, i, n, l1Fold(lanes));
+}
+
+__attribute__((target("avx2")))
+double l1DistanceAvx2(const double* a, const double* b, size_t n) noexcept {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d acc_lo = _mm256_setzero_pd();
+    __m256d acc_hi = _mm256_setzero_pd();
+    size_t i = 0;
+    for(; i + L1_LANES <= n; i += L1_LANES){
+        acc_lo = _mm256_add_pd(acc_lo, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i))));
+        acc_hi = _mm256_add_pd(acc_hi, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4))));
+    }
+
+    double lanes[L1_LANES];
+    _mm256_storeu_pd(lanes, acc_lo);
+    _mm256_storeu_pd(lanes + 4, acc_hi);
+    return l1Tail(a, b, i, n, l1Fold(lanes));
+}
+
+__attribute__((target("avx512f")))
+double l1DistanceAvx512(const double* a, const double* b, size_t n) noexcept {
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+    for(; i + L1_LANES <= n; i += L1_LANES)
+        acc = _mm512_add_pd(acc, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i))));
+
+    double lanes[L1_LANES];
+    _mm512_storeu_pd(lanes, acc);
+    return l1Tail(a, b, i, n, l1Fold(lanes));
+}
+
+#endif // CRYPTOFRIENDS_X86_KERNELS
+
+}
+
+}
+
+#endif // KERNELS_H
@@ -0,0 +1,241 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <bit>
+#include <cinttypes>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CryptoFriends {
+
+uint64_t hashBytes(std::string_view bytes, uint64_t seed = 0) noexcept {
+    //Word-at-a-time multiply/rotate mixing with a murmur finaliser. Fast, not cryptographic.
+    static constexpr uint64_t PRIME_1 = 0x9e3779b185ebca87;
+    static constexpr uint64_t PRIME_2 = 0xc2b2ae3d27d4eb4f;
+
+    uint64_t hash = seed ^ (bytes.size() * PRIME_1);
+    size_t i = 0;
+    for(; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)){
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        hash = std::rotl(hash ^ (word * PRIME_2), 31) * PRIME_1;
+    }
+    uint64_t tail = 0;
+    for(size_t shift = 0; i < bytes.size(); i++, shift += 8)
+        tail |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[i])) << shift;
+    hash = std::rotl(hash ^ (tail * PRIME_2), 31) * PRIME_1;
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccd;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb53fe1a85ec9;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+uint64_t resultCacheKey(std::string_view bytes, std::string_view parameters) noexcept {
+    //The parameters seed the content hash, so one ciphertext analysed two ways gets two entries
+    return hashBytes(bytes, hashBytes(parameters));
+}
+
+class ResultCache{
+
+public:
+    struct Entry{
+        std::string key;
+        uint64_t plaintext_offset;
+        double score;
+    };
+
+private:
+    //Content-addressed, append-only file of analysis results:
+    //   MAGIC, then records of RecordHeader followed by the key bytes, padded to 8 bytes.
+    //Readers memory-map the file and never lock; a record only counts once its checksum matches,
+    //   so a record that is still being written is simply not seen yet.
+    //Writers append whole records under an exclusive flock, so several processes can share one file.
+    //   The file never shrinks; a torn record left by a crashed writer is skipped once a complete one follows it.
+
+    static constexpr char MAGIC[8] = {'C', 'F', 'C', 'A', 'C', 'H', 'E', '1'};
+    static constexpr size_t ALIGNMENT = 8;
+
+    struct RecordHeader{
+        uint32_t record_size;
+        uint32_t key_size;
+        uint64_t hash;
+        uint64_t input_size;
+        uint64_t plaintext_offset;
+        double score;
+        uint64_t checksum;
+    };
+
+    int fd = -1;
+    const uint8_t* map = nullptr;
+    size_t mapped_size = 0;
+    size_t scanned_size = sizeof(MAGIC);
+    std::unordered_map<uint64_t, size_t> index;
+    mutable std::shared_mutex mutex;
+
+    static size_t paddedSize(size_t size) noexcept {
+        return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    static uint64_t checksum(const RecordHeader& header, const uint8_t* key) noexcept {
+        RecordHeader unsummed = header;
+        unsummed.checksum = 0;
+        const uint64_t seed = hashBytes(std::string_view(reinterpret_cast<const char*>(&unsummed), sizeof(unsummed)));
+        return hashBytes(std::string_view(reinterpret_cast<const char*>(key), header.key_size), seed);
+    }
+
+    bool remap(){
+        struct stat info;
+        if(fstat(fd, &info) != 0) return false;
+        const size_t size = static_cast<size_t>(info.st_size);
+        if(size == mapped_size) return true;
+
+        if(map) munmap(const_cast<uint8_t*>(map), mapped_size);
+        map = nullptr;
+        mapped_size = 0;
+        if(size < sizeof(MAGIC)) return false;
+
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if(mapped == MAP_FAILED) return false;
+        if(std::memcmp(mapped, MAGIC, sizeof(MAGIC)) != 0){
+            munmap(mapped, size);
+            return false;
+        }
+        map = static_cast<const uint8_t*>(mapped);
+        mapped_size = size;
+
+        return true;
+    }
+
+    bool validRecordAt(size_t offset, RecordHeader& header) const noexcept {
+        if(offset + sizeof(RecordHeader) > mapped_size) return false;
+        std::memcpy(&header, map + offset, sizeof(header));
+        const size_t record_size = paddedSize(sizeof(RecordHeader) + header.key_size);
+        if(header.record_size != record_size || offset + record_size > mapped_size) return false;
+        return checksum(header, map + offset + sizeof(RecordHeader)) == header.checksum;
+    }
+
+    void scan(){
+        RecordHeader header;
+        while(scanned_size + sizeof(RecordHeader) <= mapped_size){
+            if(validRecordAt(scanned_size, header)){
+                index.insert_or_assign(header.hash, scanned_size);
+                scanned_size += header.record_size;
+                continue;
+            }
+
+            //Writers are serialised, so an invalid record with a valid one behind it was torn by a crash.
+            //   With nothing behind it, it is most likely still being written.
+            size_t next = scanned_size + ALIGNMENT;
+            while(next + sizeof(RecordHeader) <= mapped_size && !validRecordAt(next, header)) next += ALIGNMENT;
+            if(next + sizeof(RecordHeader) > mapped_size) break;
+            scanned_size = next;
+        }
+    }
+
+    bool refresh(){
+        if(!remap()) return false;
+        scan();
+        return true;
+    }
+
+    bool find(uint64_t hash, uint64_t input_size, Entry& out) const {
+        auto found = index.find(hash);
+        if(found == index.end()) return false;
+
+        RecordHeader header;
+        std::memcpy(&header, map + found->second, sizeof(header));
+        if(header.input_size != input_size) return false;
+
+        out.key.assign(reinterpret_cast<const char*>(map + found->second + sizeof(RecordHeader)), header.key_size);
+        out.plaintext_offset = header.plaintext_offset;
+        out.score = header.score;
+        return true;
+    }
+
+public:
+    ResultCache() = default;
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    ~ResultCache(){
+        if(map) munmap(const_cast<uint8_t*>(map), mapped_size);
+        if(fd >= 0) close(fd);
+    }
+
+    bool open(const std::string& path){
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if(fd < 0) return false;
+
+        //Whoever creates the file writes the magic; the lock keeps two creators from both doing it
+        if(flock(fd, LOCK_EX) != 0) return false;
+        struct stat info;
+        bool ok = fstat(fd, &info) == 0;
+        if(ok && info.st_size == 0) ok = write(fd, MAGIC, sizeof(MAGIC)) == static_cast<ssize_t>(sizeof(MAGIC));
+        flock(fd, LOCK_UN);
+
+        std::unique_lock lock(mutex);
+        return ok && refresh();
+    }
+
+    bool isOpen() const noexcept { return map != nullptr; }
+
+    bool lookup(uint64_t hash, uint64_t input_size, Entry& out){
+        {
+            std::shared_lock lock(mutex);
+            if(!map) return false;
+            if(find(hash, input_size, out)) return true;
+        }
+
+        //Another process may have appended it since the file was last mapped
+        std::unique_lock lock(mutex);
+        return refresh() && find(hash, input_size, out);
+    }
+
+    bool insert(uint64_t hash, uint64_t input_size, const Entry& entry){
+        RecordHeader header = {
+            .record_size = static_cast<uint32_t>(paddedSize(sizeof(RecordHeader) + entry.key.size())),
+            .key_size = static_cast<uint32_t>(entry.key.size()),
+            .hash = hash,
+            .input_size = input_size,
+            .plaintext_offset = entry.plaintext_offset,
+            .score = entry.score,
+            .checksum = 0,
+        };
+        header.checksum = checksum(header, reinterpret_cast<const uint8_t*>(entry.key.data()));
+
+        std::unique_lock lock(mutex);
+        if(!map || flock(fd, LOCK_EX) != 0) return false;
+
+        //A torn record may have left the end unaligned; pad so the new record sits where readers look for it
+        struct stat info;
+        bool ok = fstat(fd, &info) == 0;
+        if(ok){
+            const size_t padding = paddedSize(static_cast<size_t>(info.st_size)) - static_cast<size_t>(info.st_size);
+            std::vector<uint8_t> record(padding + header.record_size, 0);
+            std::memcpy(record.data() + padding, &header, sizeof(header));
+            std::memcpy(record.data() + padding + sizeof(header), entry.key.data(), entry.key.size());
+            ok = write(fd, record.data(), record.size()) == static_cast<ssize_t>(record.size());
+        }
+        flock(fd, LOCK_UN);
+
+        return ok && refresh();
+    }
+};
+
+}
+
+#endif // RESULT_CACHE_H
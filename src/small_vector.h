@@ -0,0 +1,147 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+namespace CryptoFriends {
+
+template<typename T, size_t N_inline> class SmallVector{
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector moves elements with memcpy");
+    static_assert(N_inline > 0, "SmallVector needs inline capacity");
+
+private:
+    //Holds up to N_inline elements in place and only spills to the heap when that overflows.
+    //Most ByteArrays are a block or a line of text, so this keeps them off the allocator entirely.
+
+    T* ptr = inline_storage;
+    size_t n_elements = 0;
+    size_t n_capacity = N_inline;
+    T inline_storage[N_inline];
+
+    bool onHeap() const noexcept { return ptr != inline_storage; }
+
+    void release() noexcept {
+        if(onHeap()) ::operator delete(ptr);
+        ptr = inline_storage;
+        n_capacity = N_inline;
+    }
+
+    void assignRange(const T* src, size_t n){
+        n_elements = 0;
+        reserve(n);
+        std::memcpy(ptr, src, n*sizeof(T));
+        n_elements = n;
+    }
+
+    void stealFrom(SmallVector& other) noexcept {
+        if(other.onHeap()){
+            ptr = other.ptr;
+            n_capacity = other.n_capacity;
+            n_elements = other.n_elements;
+            other.ptr = other.inline_storage;
+            other.n_capacity = N_inline;
+        }else{
+            std::memcpy(inline_storage, other.inline_storage, other.n_elements*sizeof(T));
+            n_elements = other.n_elements;
+        }
+        other.n_elements = 0;
+    }
+
+public:
+    SmallVector() noexcept = default;
+
+    SmallVector(std::initializer_list<T> init){
+        assignRange(init.begin(), init.size());
+    }
+
+    SmallVector(const SmallVector& other){
+        assignRange(other.ptr, other.n_elements);
+    }
+
+    SmallVector(SmallVector&& other) noexcept {
+        stealFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other){
+        if(this != &other) assignRange(other.ptr, other.n_elements);
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if(this == &other) return *this;
+        release();
+        stealFrom(other);
+        return *this;
+    }
+
+    ~SmallVector(){
+        release();
+    }
+
+    size_t size() const noexcept { return n_elements; }
+    size_t capacity() const noexcept { return n_capacity; }
+    bool empty() const noexcept { return n_elements == 0; }
+
+    T* data() noexcept { return ptr; }
+    const T* data() const noexcept { return ptr; }
+    T* begin() noexcept { return ptr; }
+    const T* begin() const noexcept { return ptr; }
+    T* end() noexcept { return ptr + n_elements; }
+    const T* end() const noexcept { return ptr + n_elements; }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < n_elements);
+        return ptr[index];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < n_elements);
+        return ptr[index];
+    }
+
+    T& back() noexcept {
+        assert(n_elements > 0);
+        return ptr[n_elements-1];
+    }
+
+    const T& back() const noexcept {
+        assert(n_elements > 0);
+        return ptr[n_elements-1];
+    }
+
+    void reserve(size_t n){
+        if(n <= n_capacity) return;
+        T* grown = static_cast<T*>(::operator new(n*sizeof(T)));
+        std::memcpy(grown, ptr, n_elements*sizeof(T));
+        if(onHeap()) ::operator delete(ptr);
+        ptr = grown;
+        n_capacity = n;
+    }
+
+    void push_back(T value){
+        if(n_elements == n_capacity) reserve(2*n_capacity);
+        ptr[n_elements++] = value;
+    }
+
+    void resize(size_t n){
+        reserve(n);
+        if(n > n_elements) std::fill(ptr + n_elements, ptr + n, T());
+        n_elements = n;
+    }
+
+    void assign(size_t n, T value){
+        n_elements = 0;
+        reserve(n);
+        std::fill(ptr, ptr + n, value);
+        n_elements = n;
+    }
+};
+
+}
+
+#endif // SMALL_VECTOR_H
@@ -1,6 +1,8 @@
 #ifndef TEXTFREQUENCYANALYSIS_H
 #define TEXTFREQUENCYANALYSIS_H
 
+#include "cpu_dispatch.h"
+
 #include <array>
 #include <cassert>
 #include <numeric>
@@ -22,12 +24,7 @@ std::array<double, PERMUTATIONS_PER_BYTE> getFrequencies(std::string_view str) n
 }
 
 double l1Score(const Frequency& frequencies) noexcept {
-    double residual = 0;
-    for(size_t i = 0; i < PERMUTATIONS_PER_BYTE; i++)
-        //if(frequencies[i] > 0 && FREQUENCY_MAP[i] == 0) residual += 0.5; else
-        residual += std::abs(frequencies[i] - FREQUENCY_MAP[i]);
-
-    return residual;
+    return kernels().l1_distance(frequencies.data(), FREQUENCY_MAP.data(), PERMUTATIONS_PER_BYTE);
 }
 
 double l1Score(std::string_view str) noexcept {
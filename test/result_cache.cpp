@@ -0,0 +1,89 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "result_cache.h"
+
+using namespace CryptoFriends;
+
+static constexpr uint64_t INPUT_SIZE = 64;
+
+static bool hasEntry(ResultCache& cache, uint64_t hash, const ResultCache::Entry& expected){
+    ResultCache::Entry entry;
+    return cache.lookup(hash, INPUT_SIZE, entry) && entry.key == expected.key
+           && entry.plaintext_offset == expected.plaintext_offset && entry.score == expected.score;
+}
+
+bool Result_Cache_Torn_Record(){
+    bool fail = false;
+
+    //A writer that dies mid-append leaves a partial record; readers should skip it and find what follows
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "cryptofriends_torn_record.cache";
+    const ResultCache::Entry first = {.key = "ICE", .plaintext_offset = 0, .score = 0.25};
+    const ResultCache::Entry torn = {.key = "Terminator X: Bring the noise", .plaintext_offset = 3, .score = 0.5};
+    const ResultCache::Entry appended = {.key = "Vanilla", .plaintext_offset = 7, .score = 0.75};
+    static constexpr uint64_t FIRST_HASH = 1;
+    static constexpr uint64_t TORN_HASH = 2;
+    static constexpr uint64_t APPENDED_HASH = 3;
+
+    //Cut inside the torn record's header, then inside its key
+    static constexpr size_t CUTS_INTO_RECORD[] = {20, 60};
+    for(size_t cut : CUTS_INTO_RECORD){
+        std::filesystem::remove(path);
+
+        uintmax_t torn_offset;
+        {
+            ResultCache cache;
+            if(!cache.open(path.string())){
+                std::cout << "ResultCache: could not open " << path << std::endl;
+                return true;
+            }
+            cache.insert(FIRST_HASH, INPUT_SIZE, first);
+            torn_offset = std::filesystem::file_size(path);
+            cache.insert(TORN_HASH, INPUT_SIZE, torn);
+        }
+        std::filesystem::resize_file(path, torn_offset + cut);
+
+        {
+            ResultCache cache;
+            cache.open(path.string());
+            if(!hasEntry(cache, FIRST_HASH, first)){
+                fail = true;
+                std::cout << "ResultCache: lost the record before a torn one (cut " << cut << ")" << std::endl;
+            }
+            if(hasEntry(cache, TORN_HASH, torn)){
+                fail = true;
+                std::cout << "ResultCache: accepted a torn record (cut " << cut << ")" << std::endl;
+            }
+
+            cache.insert(APPENDED_HASH, INPUT_SIZE, appended);
+            if(!hasEntry(cache, APPENDED_HASH, appended)){
+                fail = true;
+                std::cout << "ResultCache: missed a record appended after a torn one (cut " << cut << ")" << std::endl;
+            }
+        }
+
+        ResultCache reopened;
+        reopened.open(path.string());
+        if(!hasEntry(reopened, FIRST_HASH, first) || hasEntry(reopened, TORN_HASH, torn)
+           || !hasEntry(reopened, APPENDED_HASH, appended)){
+            fail = true;
+            std::cout << "ResultCache: reopening did not skip the torn record (cut " << cut << ")" << std::endl;
+        }
+    }
+
+    std::filesystem::remove(path);
+
+    if(!fail) std::cout << "ResultCache torn record: passing" << std::endl;
+
+    return fail;
+}
+
+int main(){
+    bool failed = false;
+    failed |= Result_Cache_Torn_Record();
+
+    if(!failed) std::cout << "No failures" << std::endl;
+
+    return failed;
+}
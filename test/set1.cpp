@@ -6,8 +6,10 @@
 #include <sstream>
 #include <vector>
 
+#include "analysis.h"
 #include "base64.h"
 #include "bytearray.h"
+#include "cpu_dispatch.h"
 #include "decrypt.h"
 #include "hex.h"
 #include "text_frequency_analysis.h"
@@ -26,6 +28,17 @@ static std::string getFileContents(const char* file_name){
     return str;
 }
 
+static std::string printableKey(size_t key_size, uint32_t seed){
+    //A reproducible stand-in for a random key, drawn from the printable range the key search covers
+    std::string key;
+    uint32_t state = seed;
+    for(size_t i = 0; i < key_size; i++){
+        state = state * 1103515245 + 12345;
+        key += static_cast<char>(' ' + (state >> 16) % 95);
+    }
+    return key;
+}
+
 bool Set_1_Problem_1(){
     static constexpr char bin_str[] =
         "010010010010011101101101001000000110101101101001011011000110110001101001011011100110011100100000011110010110111101110101011100100010000001100010011100100110000101101001011011100010000001101100011010010110101101100101001000000110000100100000011100000110111101101001011100110110111101101110011011110111010101110011001000000110110101110101011100110110100001110010011011110110111101101101";
@@ -218,37 +231,7 @@ bool Set_1_Problem_6(){
     static constexpr size_t KEY_SIZE_MIN_BYTES = 2;
     static constexpr size_t KEY_SIZE_MAX_BYTES = 40;
 
-    struct Result{
-        size_t key_size;
-        double normalised_edit_distance;
-    };
-
-    std::vector<Result> results;
-
-    for(size_t key_size = KEY_SIZE_MIN_BYTES; key_size <= KEY_SIZE_MAX_BYTES; key_size++){
-        size_t differing_bits = 0;
-
-        for(size_t byte = 0; byte < key_size; byte++){
-            const size_t a = encrypted_bytes.getByte(byte);
-            const size_t b = encrypted_bytes.getByte(key_size + byte);
-            const size_t diff = a ^ b;
-            for(uint8_t j = 0; j < BITS_PER_BYTE; j++)
-                differing_bits += isBitSet(diff, j);
-        }
-
-        double normalised_edit_distance = static_cast<double>(differing_bits) / key_size;
-
-        results.push_back(Result{
-            .key_size = key_size,
-            .normalised_edit_distance = normalised_edit_distance
-        });
-    }
-
-    std::sort(
-        results.begin(),
-        results.end(),
-        [](const Result& a, const Result& b){return a.normalised_edit_distance < b.normalised_edit_distance;}
-    );
+    const std::vector<KeySizeScore> results = rankKeySizesByHamming(encrypted_bytes, KEY_SIZE_MIN_BYTES, KEY_SIZE_MAX_BYTES);
 
     static constexpr size_t RESULTS_TO_USE = 35;
 
@@ -257,7 +240,7 @@ bool Set_1_Problem_6(){
     std::string decrypted_msg;
 
     for(size_t i = 0; i < RESULTS_TO_USE; i++){
-        const Result& result = results[i];
+        const KeySizeScore& result = results[i];
         std::string guessed_key = encrypted_bytes.bestRepeatingXorKey(result.key_size);
         ByteArray decrypted = encrypted_bytes;
         decrypted.applyRepeatingKeyXor(guessed_key);
@@ -281,6 +264,66 @@ bool Set_1_Problem_6(){
         std::cout << "S1P6: failed to decode message" << std::endl;
     }
 
+    //Autocorrelation scores every shift over the whole ciphertext, so it should pick the key size outright
+    if(likelyKeySizeByAutocorrelation(encrypted_bytes, KEY_SIZE_MIN_BYTES, KEY_SIZE_MAX_BYTES) != KEY_SOLVED.size()){
+        fail = true;
+        std::cout << "S1P6: autocorrelation picked the wrong key size" << std::endl;
+    }
+
+    //...and still find a key which only repeats about ten times
+    static constexpr size_t LONG_KEY_SIZE = 257;
+    static constexpr size_t LONG_KEY_SIZE_MAX_BYTES = 1000;
+    const std::string long_key = printableKey(LONG_KEY_SIZE, 1);
+    ByteArray long_key_encrypted = ByteArray::fromAscii(getFileContents("6_solved.txt"));
+    long_key_encrypted.applyRepeatingKeyXor(long_key);
+    if(likelyKeySizeByAutocorrelation(long_key_encrypted, KEY_SIZE_MIN_BYTES, LONG_KEY_SIZE_MAX_BYTES) != LONG_KEY_SIZE){
+        fail = true;
+        std::cout << "S1P6: autocorrelation missed a long key size" << std::endl;
+    }
+
+    //Short keys with small divisors should come back at their own size, not repeated
+    const std::string solved = getFileContents("6_solved.txt");
+    static constexpr size_t SHORT_PREFIX_BYTES = 400;
+    for(std::string_view short_key : {"IT", "RHYMES"}){
+        for(size_t num_bytes : {SHORT_PREFIX_BYTES, solved.size()}){
+            const std::string plain_text = solved.substr(0, num_bytes);
+            ByteArray short_key_encrypted = ByteArray::fromAscii(plain_text);
+            short_key_encrypted.applyRepeatingKeyXor(short_key);
+            const RepeatingXorResult result =
+                breakRepeatingKeyXor(short_key_encrypted, KEY_SIZE_MIN_BYTES, KEY_SIZE_MAX_BYTES, RESULTS_TO_USE);
+            if(result.key != short_key || result.plain_text != plain_text){
+                fail = true;
+                std::cout << "S1P6: failed to find short key " << short_key << " in " << num_bytes << " bytes" << std::endl;
+            }
+        }
+    }
+
+    //Keys whose best autocorrelation divisor undershoots the key size still have to be tried at their own size
+    struct DivisorCase{
+        size_t key_size;
+        uint32_t seed;
+        size_t offset;
+        size_t num_bytes;
+    };
+    static constexpr DivisorCase DIVISOR_CASES[] = {
+        {.key_size = 10, .seed = 26, .offset = 0, .num_bytes = std::string_view::npos},
+        {.key_size = 8, .seed = 74, .offset = 0, .num_bytes = std::string_view::npos},
+        {.key_size = 28, .seed = 585, .offset = 1200, .num_bytes = SHORT_PREFIX_BYTES},
+    };
+    for(const DivisorCase& divisor_case : DIVISOR_CASES){
+        const std::string key = printableKey(divisor_case.key_size, divisor_case.seed);
+        const std::string plain_text = solved.substr(divisor_case.offset, divisor_case.num_bytes);
+        ByteArray divisor_encrypted = ByteArray::fromAscii(plain_text);
+        divisor_encrypted.applyRepeatingKeyXor(key);
+        const RepeatingXorResult result =
+            breakRepeatingKeyXor(divisor_encrypted, KEY_SIZE_MIN_BYTES, KEY_SIZE_MAX_BYTES, RESULTS_TO_USE);
+        if(result.key != key || result.plain_text != plain_text){
+            fail = true;
+            std::cout << "S1P6: found a " << result.key.size() << " byte key instead of the "
+                      << divisor_case.key_size << " byte key" << std::endl;
+        }
+    }
+
     if(!fail) std::cout << "S1P6: passing" << std::endl;
 
     return fail;
@@ -327,14 +370,31 @@ bool Set_1_Problem_8(){
 
 int main(){
     bool failed = false;
-    failed |= Set_1_Problem_1();
-    failed |= Set_1_Problem_2();
-    failed |= Set_1_Problem_3();
-    failed |= Set_1_Problem_4();
-    failed |= Set_1_Problem_5();
-    failed |= Set_1_Problem_6();
-    failed |= Set_1_Problem_7();
-    failed |= Set_1_Problem_8();
+
+    //Scores decide between candidate keys, so every tier has to score exactly like the scalar kernels
+    const std::string scored_text = getFileContents("6_solved.txt");
+    forceIsa(Isa::Scalar);
+    const double scalar_score = l1Score(scored_text);
+
+    //Every supported kernel tier has to solve the set on its own
+    for(Isa isa : ALL_ISAS){
+        if(forceIsa(isa) != isa) continue;
+        std::cout << "Kernels: " << isaName(isa) << std::endl;
+
+        if(l1Score(scored_text) != scalar_score){
+            failed = true;
+            std::cout << "Kernels: l1 score differs from the scalar kernel" << std::endl;
+        }
+
+        failed |= Set_1_Problem_1();
+        failed |= Set_1_Problem_2();
+        failed |= Set_1_Problem_3();
+        failed |= Set_1_Problem_4();
+        failed |= Set_1_Problem_5();
+        failed |= Set_1_Problem_6();
+        failed |= Set_1_Problem_7();
+        failed |= Set_1_Problem_8();
+    }
 
     if(!failed) std::cout << "No failures" << std::endl;
 
@@ -0,0 +1,80 @@
+#include <cassert>
+#include <iostream>
+
+#include "bytearray.h"
+#include "decrypt.h"
+#include "ecb_oracle.h"
+
+using namespace CryptoFriends;
+
+bool Set_2_Problem_9(){
+    bool fail = false;
+
+    static constexpr std::string_view block = "YELLOW SUBMARINE";
+    static constexpr std::string_view padded = "YELLOW SUBMARINE\x04\x04\x04\x04";
+
+    if(pkcs7Pad(block, 20) != padded){
+        fail = true;
+        std::cout << "S2P9: incorrect PKCS#7 padding" << std::endl;
+    }
+
+    if(pkcs7Pad(block, 16).size() != 32){
+        fail = true;
+        std::cout << "S2P9: aligned input should gain a full padding block" << std::endl;
+    }
+
+    if(!fail) std::cout << "S2P9: passing" << std::endl;
+
+    return fail;
+}
+
+bool Set_2_Problem_12(){
+    bool fail = false;
+
+    static constexpr std::string_view secret_base64 =
+            "Um9sbGluJyBpbiBteSA1LjAKV2l0aCBteSByYWctdG9wIGRvd24gc28gbXkg"
+            "aGFpciBjYW4gYmxvdwpUaGUgZ2lybGllcyBvbiBzdGFuZGJ5IHdhdmluZyBq"
+            "dXN0IHRvIHNheSBoaQpEaWQgeW91IHN0b3A/IE5vLCBJIGp1c3QgZHJvdmUg"
+            "YnkK";
+
+    static constexpr std::string_view decrypted_msg =
+            "Rollin' in my 5.0\n"
+            "With my rag-top down so my hair can blow\n"
+            "The girlies on standby waving just to say hi\n"
+            "Did you stop? No, I just drove by\n";
+
+    const std::string secret = ByteArray::fromBase64String(secret_base64).toAscii();
+    if(secret != decrypted_msg){
+        fail = true;
+        std::cout << "S2P12: failed to decode secret" << std::endl;
+    }
+
+    const EcbOracle oracle(secret);
+    const std::string recovered = byteAtATimeEcbDecrypt(oracle);
+
+    if(recovered != decrypted_msg){
+        fail = true;
+        std::cout << "S2P12: failed to recover secret from oracle" << std::endl;
+    }
+
+    //One batched call per recovered byte, plus the calls spent sizing the blocks
+    const size_t max_calls = secret.size() + AES_BLOCK_SIZE + 1;
+    if(oracle.numCalls() > max_calls){
+        fail = true;
+        std::cout << "S2P12: too many oracle calls (" << oracle.numCalls() << ")" << std::endl;
+    }
+
+    if(!fail) std::cout << "S2P12: passing" << std::endl;
+
+    return fail;
+}
+
+int main(){
+    bool failed = false;
+    failed |= Set_2_Problem_9();
+    failed |= Set_2_Problem_12();
+
+    if(!failed) std::cout << "No failures" << std::endl;
+
+    return failed;
+}
@@ -0,0 +1,131 @@
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "bytearray.h"
+#include "small_vector.h"
+
+using namespace CryptoFriends;
+
+//Counts every heap allocation, so the tests can tell inline storage from a spill
+static size_t allocations = 0;
+
+void* operator new(size_t size){
+    allocations++;
+    if(void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+static constexpr size_t N_INLINE = 4;
+typedef SmallVector<size_t, N_INLINE> Vector;
+
+static Vector filled(size_t n){
+    Vector vector;
+    for(size_t i = 0; i < n; i++) vector.push_back(i);
+    return vector;
+}
+
+static bool holdsSequence(const Vector& vector, size_t n){
+    if(vector.size() != n) return false;
+    for(size_t i = 0; i < n; i++)
+        if(vector[i] != i) return false;
+    return true;
+}
+
+bool Small_Vector_Storage(){
+    bool fail = false;
+
+    size_t before = allocations;
+    Vector inline_vector = filled(N_INLINE);
+    if(allocations != before || !holdsSequence(inline_vector, N_INLINE)){
+        fail = true;
+        std::cout << "SmallVector: allocated while the elements fit inline" << std::endl;
+    }
+
+    before = allocations;
+    Vector spilled = filled(N_INLINE + 1);
+    if(allocations != before + 1 || spilled.capacity() <= N_INLINE || !holdsSequence(spilled, N_INLINE + 1)){
+        fail = true;
+        std::cout << "SmallVector: did not spill to the heap intact" << std::endl;
+    }
+
+    before = allocations;
+    Vector moved_inline = std::move(inline_vector);
+    if(allocations != before || !holdsSequence(moved_inline, N_INLINE) || !inline_vector.empty()){
+        fail = true;
+        std::cout << "SmallVector: moving from inline storage lost elements" << std::endl;
+    }
+
+    const size_t* heap_data = spilled.data();
+    before = allocations;
+    Vector moved_heap = std::move(spilled);
+    if(allocations != before || moved_heap.data() != heap_data || !holdsSequence(moved_heap, N_INLINE + 1)
+       || !spilled.empty()){
+        fail = true;
+        std::cout << "SmallVector: moving from the heap did not take over the buffer" << std::endl;
+    }
+
+    Vector assigned = filled(2);
+    assigned = moved_heap;
+    moved_heap[0] = N_INLINE;
+    if(!holdsSequence(assigned, N_INLINE + 1) || assigned.data() == moved_heap.data()){
+        fail = true;
+        std::cout << "SmallVector: copy-assigning a heap vector over an inline one shared or lost elements" << std::endl;
+    }
+
+    assigned = moved_inline;
+    if(!holdsSequence(assigned, N_INLINE)){
+        fail = true;
+        std::cout << "SmallVector: copy-assigning an inline vector over a heap one lost elements" << std::endl;
+    }
+
+    if(!fail) std::cout << "SmallVector storage: passing" << std::endl;
+
+    return fail;
+}
+
+bool Small_Vector_Byte_Array_Limit(){
+    bool fail = false;
+
+    //One word is always partly unused, so 63 bytes is the most a ByteArray holds without allocating
+    static constexpr size_t MAX_INLINE_BYTES = 63;
+    const std::string longest_inline(MAX_INLINE_BYTES, 'A');
+    const std::string first_spilled(MAX_INLINE_BYTES + 1, 'A');
+
+    size_t before = allocations;
+    const ByteArray inline_array = ByteArray::fromAscii(longest_inline);
+    if(allocations != before){
+        fail = true;
+        std::cout << "SmallVector: a " << MAX_INLINE_BYTES << " byte ByteArray allocated" << std::endl;
+    }
+
+    before = allocations;
+    const ByteArray spilled_array = ByteArray::fromAscii(first_spilled);
+    if(allocations == before){
+        fail = true;
+        std::cout << "SmallVector: a " << MAX_INLINE_BYTES + 1 << " byte ByteArray did not spill" << std::endl;
+    }
+
+    if(inline_array.toAscii() != longest_inline || spilled_array.toAscii() != first_spilled){
+        fail = true;
+        std::cout << "SmallVector: ByteArray contents changed around the inline limit" << std::endl;
+    }
+
+    if(!fail) std::cout << "SmallVector ByteArray limit: passing" << std::endl;
+
+    return fail;
+}
+
+int main(){
+    bool failed = false;
+    failed |= Small_Vector_Storage();
+    failed |= Small_Vector_Byte_Array_Limit();
+
+    if(!failed) std::cout << "No failures" << std::endl;
+
+    return failed;
+}